@@ -27,8 +27,6 @@ public:
 	vec2	mCurrentSquarePos;
 	bool	mUpdatedTarget;
 	
-	std::mutex mCirclePosMutex, mSquarePosMutex;
-	
 #if USE_UDP
 	osc::ReceiverUdp mReceiver;
 #else
@@ -38,23 +36,28 @@ public:
 
 SimpleMultiThreadedReceiverApp::SimpleMultiThreadedReceiverApp()
 : mIoService( new asio::io_service ), mWork( new asio::io_service::work( *mIoService ) ),
-	mReceiver( 10001 )
+#if USE_UDP
+	mReceiver( 10001, osc::ReceiverUdp::protocol::v4(), *mIoService )
+#else
+	mReceiver( 10001, osc::ReceiverTcp::protocol::v4(), *mIoService )
+#endif
 {
 }
 
 void SimpleMultiThreadedReceiverApp::setup()
 {
+	// The listeners are called from poll() in draw(), so they run on the main thread and need no
+	// locking, while the messages are received on mThread.
 	mReceiver.setListener( "/mousemove/1",
 	[&]( const osc::Message &msg ){
-		std::lock_guard<std::mutex> lock( mCirclePosMutex );
 		mCurrentCirclePos.x = msg[0].int32();
 		mCurrentCirclePos.y = msg[1].int32();
 	});
 	mReceiver.setListener( "/mouseclick/1",
 	[&]( const osc::Message &msg ){
-		std::lock_guard<std::mutex> lock( mSquarePosMutex );
 		mCurrentSquarePos = vec2( msg[0].flt(), msg[1].flt() ) * vec2( getWindowSize() );
 	});
+	mReceiver.setPolling( 1024 );
 	
 	mReceiver.bind();
 	mReceiver.listen();
@@ -67,18 +70,13 @@ void SimpleMultiThreadedReceiverApp::setup()
 
 void SimpleMultiThreadedReceiverApp::draw()
 {
+	mReceiver.poll();
+	
 	gl::clear( GL_COLOR_BUFFER_BIT );
 	gl::setMatricesWindow( getWindowSize() );
 	
-	{
-		std::lock_guard<std::mutex> lock( mCirclePosMutex );
-		gl::drawStrokedCircle( mCurrentCirclePos, 100 );
-	}
-	
-	{
-		std::lock_guard<std::mutex> lock( mSquarePosMutex );
-		gl::drawSolidRect( Rectf( mCurrentSquarePos - vec2( 50 ), mCurrentSquarePos + vec2( 50 ) ) );
-	}
+	gl::drawStrokedCircle( mCurrentCirclePos, 100 );
+	gl::drawSolidRect( Rectf( mCurrentSquarePos - vec2( 50 ), mCurrentSquarePos + vec2( 50 ) ) );
 }
 
 void SimpleMultiThreadedReceiverApp::cleanup()
@@ -31,6 +31,35 @@
 #include "Osc.h"
 #include "cinder/Log.h"
 
+#include <bitset>
+
+#if defined( __AVX2__ )
+#include <immintrin.h>
+#endif
+#if defined( __SSSE3__ )
+#include <tmmintrin.h>
+#elif defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#include <emmintrin.h>
+#define OSC_SSE2
+#endif
+#if defined( _MSC_VER )
+#include <intrin.h>
+#endif
+
+#if defined( __linux__ )
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <sys/uio.h>
+#include <climits>
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+#endif
+
 using namespace std;
 using namespace asio;
 using namespace asio::ip;
@@ -73,6 +102,292 @@ inline double ntohf( int32_t x ) { x = ntohl( x ); return *(float*) &x; }
 /// Convert 64-bit big-endian network format to double
 inline double ntohd( int64_t x ) { return (double) ntohll( x ); }
 	
+////////////////////////////////////////////////////////////////////////////////////////
+//// Byte swapping
+
+//! Swaps the byte order of \a count consecutive 4 byte values at \a data, in place.
+static void swapEndian32( uint8_t *data, size_t count )
+{
+	size_t i = 0;
+#if defined( __AVX2__ )
+	const __m256i mask256 = _mm256_setr_epi8( 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+											  3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 );
+	for( ; i + 8 <= count; i += 8 ) {
+		auto ptr = reinterpret_cast<__m256i*>( data + i * 4 );
+		_mm256_storeu_si256( ptr, _mm256_shuffle_epi8( _mm256_loadu_si256( ptr ), mask256 ) );
+	}
+#endif
+#if defined( __SSSE3__ )
+	const __m128i mask = _mm_setr_epi8( 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 );
+	for( ; i + 4 <= count; i += 4 ) {
+		auto ptr = reinterpret_cast<__m128i*>( data + i * 4 );
+		_mm_storeu_si128( ptr, _mm_shuffle_epi8( _mm_loadu_si128( ptr ), mask ) );
+	}
+#elif defined( OSC_SSE2 )
+	for( ; i + 4 <= count; i += 4 ) {
+		auto ptr = reinterpret_cast<__m128i*>( data + i * 4 );
+		auto v = _mm_loadu_si128( ptr );
+		// swap the 16 bit halves of each value, then the bytes of each half.
+		v = _mm_shufflehi_epi16( _mm_shufflelo_epi16( v, 0xB1 ), 0xB1 );
+		v = _mm_or_si128( _mm_slli_epi16( v, 8 ), _mm_srli_epi16( v, 8 ) );
+		_mm_storeu_si128( ptr, v );
+	}
+#endif
+	for( ; i < count; i++ ) {
+		uint32_t v;
+		memcpy( &v, data + i * 4, 4 );
+		v = htonl( v );
+		memcpy( data + i * 4, &v, 4 );
+	}
+}
+
+//! Swaps the byte order of \a count consecutive 8 byte values at \a data, in place.
+static void swapEndian64( uint8_t *data, size_t count )
+{
+	size_t i = 0;
+#if defined( __AVX2__ )
+	const __m256i mask256 = _mm256_setr_epi8( 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+											  7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8 );
+	for( ; i + 4 <= count; i += 4 ) {
+		auto ptr = reinterpret_cast<__m256i*>( data + i * 8 );
+		_mm256_storeu_si256( ptr, _mm256_shuffle_epi8( _mm256_loadu_si256( ptr ), mask256 ) );
+	}
+#endif
+#if defined( __SSSE3__ )
+	const __m128i mask = _mm_setr_epi8( 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8 );
+	for( ; i + 2 <= count; i += 2 ) {
+		auto ptr = reinterpret_cast<__m128i*>( data + i * 8 );
+		_mm_storeu_si128( ptr, _mm_shuffle_epi8( _mm_loadu_si128( ptr ), mask ) );
+	}
+#elif defined( OSC_SSE2 )
+	for( ; i + 2 <= count; i += 2 ) {
+		auto ptr = reinterpret_cast<__m128i*>( data + i * 8 );
+		auto v = _mm_loadu_si128( ptr );
+		// reverse the 16 bit words of each value, then the bytes of each word.
+		v = _mm_shufflehi_epi16( _mm_shufflelo_epi16( v, 0x1B ), 0x1B );
+		v = _mm_or_si128( _mm_slli_epi16( v, 8 ), _mm_srli_epi16( v, 8 ) );
+		_mm_storeu_si128( ptr, v );
+	}
+#endif
+	for( ; i < count; i++ ) {
+		uint64_t v;
+		memcpy( &v, data + i * 8, 8 );
+		v = htonll( v );
+		memcpy( data + i * 8, &v, 8 );
+	}
+}
+
+//! Returns the size of the value that needs a byte swap on the wire for \a type, or 0.
+static uint32_t getEndianSwapSize( ArgType type )
+{
+	switch( type ) {
+		case ArgType::INTEGER_32:
+		case ArgType::FLOAT:
+		case ArgType::CHAR:
+		// a blob's size prefix
+		case ArgType::BLOB: return 4;
+		case ArgType::INTEGER_64:
+		case ArgType::DOUBLE:
+		case ArgType::TIME_TAG: return 8;
+		default: return 0;
+	}
+}
+
+//! Swaps the byte order of every argument in [\a begin, \a end) within \a buffer, which holds the
+//! arguments' data. Runs of adjacent arguments of the same size are swapped in one batch. The same
+//! pass converts to the wire format on send and back to host order on receive.
+static void swapArgumentRuns( const Message::Argument *begin, const Message::Argument *end, uint8_t *buffer )
+{
+	auto it = begin;
+	while( it != end ) {
+		auto swapSize = getEndianSwapSize( it->getType() );
+		if( swapSize == 0 ) {
+			++it;
+			continue;
+		}
+		
+		size_t runOffset = it->getOffset();
+		size_t nextOffset = runOffset + swapSize;
+		size_t count = 1;
+		while( ++it != end && getEndianSwapSize( it->getType() ) == swapSize && size_t( it->getOffset() ) == nextOffset ) {
+			nextOffset += swapSize;
+			count++;
+		}
+		
+		if( swapSize == 4 )
+			swapEndian32( buffer + runOffset, count );
+		else
+			swapEndian64( buffer + runOffset, count );
+	}
+}
+	
+////////////////////////////////////////////////////////////////////////////////////////
+//// Byte scanning
+
+//! Returns the index of the lowest set bit of the non zero \a mask.
+static inline uint32_t getLowestSetBit( uint32_t mask )
+{
+#if defined( _MSC_VER )
+	unsigned long index;
+	_BitScanForward( &index, mask );
+	return index;
+#else
+	return __builtin_ctz( mask );
+#endif
+}
+
+static inline uint32_t getLowestSetBit( uint64_t mask )
+{
+#if defined( _MSC_VER ) && defined( _WIN64 )
+	unsigned long index;
+	_BitScanForward64( &index, mask );
+	return index;
+#elif defined( _MSC_VER )
+	auto low = uint32_t( mask );
+	return low ? getLowestSetBit( low ) : 32 + getLowestSetBit( uint32_t( mask >> 32 ) );
+#else
+	return __builtin_ctzll( mask );
+#endif
+}
+
+//! Returns the index of the first null byte of the \a size bytes at \a data, or \a size if there's
+//! none. Never reads past \a size.
+static size_t findNull( const uint8_t *data, size_t size )
+{
+	size_t i = 0;
+#if defined( __AVX2__ )
+	const __m256i zero256 = _mm256_setzero_si256();
+	for( ; i + 32 <= size; i += 32 ) {
+		auto bytes = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( data + i ) );
+		auto mask = uint32_t( _mm256_movemask_epi8( _mm256_cmpeq_epi8( bytes, zero256 ) ) );
+		if( mask )
+			return i + getLowestSetBit( mask );
+	}
+#endif
+#if defined( __SSSE3__ ) || defined( OSC_SSE2 )
+	const __m128i zero = _mm_setzero_si128();
+	for( ; i + 16 <= size; i += 16 ) {
+		auto bytes = _mm_loadu_si128( reinterpret_cast<const __m128i*>( data + i ) );
+		auto mask = uint32_t( _mm_movemask_epi8( _mm_cmpeq_epi8( bytes, zero ) ) );
+		if( mask )
+			return i + getLowestSetBit( mask );
+	}
+#endif
+	for( ; i < size; i++ ) {
+		if( data[i] == '\0' )
+			return i;
+	}
+	return size;
+}
+	
+////////////////////////////////////////////////////////////////////////////////////////
+//// MonotonicArena
+
+MonotonicArena::MonotonicArena( size_t blockSize )
+: mBlockSize( blockSize ), mCurrentBlock( 0 ), mOffset( 0 )
+{
+}
+
+MonotonicArena::~MonotonicArena()
+{
+	for( auto & block : mBlocks )
+		::operator delete( block.first );
+}
+
+void* MonotonicArena::allocate( size_t bytes, size_t alignment )
+{
+	while( mCurrentBlock < mBlocks.size() ) {
+		auto &block = mBlocks[mCurrentBlock];
+		auto address = reinterpret_cast<uintptr_t>( block.first ) + mOffset;
+		auto padding = ( alignment - address % alignment ) % alignment;
+		if( mOffset + padding + bytes <= block.second ) {
+			mOffset += padding + bytes;
+			return block.first + mOffset - bytes;
+		}
+		mCurrentBlock++;
+		mOffset = 0;
+	}
+	
+	// Out of blocks, make room for at least this allocation.
+	auto size = std::max( mBlockSize, bytes + alignment );
+	mBlocks.emplace_back( static_cast<uint8_t*>( ::operator new( size ) ), size );
+	mCurrentBlock = mBlocks.size() - 1;
+	mOffset = 0;
+	return allocate( bytes, alignment );
+}
+
+void MonotonicArena::reset()
+{
+	mCurrentBlock = 0;
+	mOffset = 0;
+}
+	
+////////////////////////////////////////////////////////////////////////////////////////
+//// AddressId
+	
+namespace {
+	
+//! The process wide table of interned addresses.
+struct AddressTable {
+	std::mutex									mMutex;
+	//! Maps the hashes of the addresses to their ids.
+	std::unordered_multimap<uint64_t, uint32_t>	mIds;
+	//! The address of each id, less one. References to them stay valid as the deque grows.
+	std::deque<std::string>						mAddresses;
+};
+	
+AddressTable& getAddressTable()
+{
+	static AddressTable table;
+	return table;
+}
+	
+//! Same as hashAddress, without recursing for long runtime addresses.
+uint64_t hashAddressBytes( const char *address, size_t length )
+{
+	uint64_t hash = 14695981039346656037ULL;
+	for( size_t i = 0; i < length; ++i )
+		hash = ( hash ^ uint8_t( address[i] ) ) * 1099511628211ULL;
+	return hash;
+}
+	
+} // anonymous namespace
+
+AddressId::AddressId( const std::string &address )
+: AddressId( intern( address.data(), address.size(), hashAddressBytes( address.data(), address.size() ) ) )
+{
+}
+
+AddressId::AddressId( const AddressLiteral &literal )
+: AddressId( intern( literal.mAddress, literal.mLength, literal.mHash ) )
+{
+}
+
+const std::string& AddressId::getAddress() const
+{
+	static const std::string sEmpty;
+	if( ! mValue )
+		return sEmpty;
+	auto &table = getAddressTable();
+	std::lock_guard<std::mutex> lock( table.mMutex );
+	return table.mAddresses[mValue - 1];
+}
+
+AddressId AddressId::intern( const char *address, size_t length, uint64_t hash )
+{
+	auto &table = getAddressTable();
+	std::lock_guard<std::mutex> lock( table.mMutex );
+	auto range = table.mIds.equal_range( hash );
+	for( auto it = range.first; it != range.second; ++it ) {
+		if( ! table.mAddresses[it->second - 1].compare( 0, std::string::npos, address, length ) )
+			return AddressId( it->second );
+	}
+	table.mAddresses.emplace_back( address, length );
+	auto value = static_cast<uint32_t>( table.mAddresses.size() );
+	table.mIds.emplace( hash, value );
+	return AddressId( value );
+}
+	
 ////////////////////////////////////////////////////////////////////////////////////////
 //// MESSAGE
 	
@@ -80,11 +395,22 @@ Message::Message( const std::string& address )
 : mAddress( address ), mIsCached( false )
 {
 }
+
+Message::Message( const AddressId &address )
+: mAddress( address.getAddress() ), mAddressId( address ), mIsCached( false )
+{
+}
+
+Message::Message( MemoryResource *resource, const std::string& address )
+: mAddress( address ), mDataBuffer( resource ), mDataViews( resource ), mIsCached( false ),
+	mResource( resource )
+{
+}
 	
 Message::Message( Message &&message ) NOEXCEPT
-: mAddress( move( message.mAddress ) ), mDataBuffer( move( message.mDataBuffer ) ),
+: mAddress( move( message.mAddress ) ), mAddressId( message.mAddressId ), mDataBuffer( move( message.mDataBuffer ) ),
 	mDataViews( move( message.mDataViews ) ), mIsCached( message.mIsCached ),
-	mCache( move( message.mCache ) )
+	mCache( move( message.mCache ) ), mResource( message.mResource )
 {
 	for( auto & dataView : mDataViews ) {
 		dataView.mOwner = this;
@@ -95,10 +421,12 @@ Message& Message::operator=( Message &&message ) NOEXCEPT
 {
 	if( this != &message ) {
 		mAddress = move( message.mAddress );
+		mAddressId = message.mAddressId;
 		mDataBuffer = move( message.mDataBuffer );
 		mDataViews = move( message.mDataViews );
 		mIsCached = message.mIsCached;
 		mCache = move( message.mCache );
+		mResource = message.mResource;
 		for( auto & dataView : mDataViews ) {
 			dataView.mOwner = this;
 		}
@@ -160,6 +488,8 @@ ArgType Argument::translateCharToArgType( char type )
 		case 'F': return ArgType::BOOL_F; break;
 		case 'N': return ArgType::NULL_T; break;
 		case 'I': return ArgType::INFINITUM; break;
+		case '[': return ArgType::ARRAY_BEGIN; break;
+		case ']': return ArgType::ARRAY_END; break;
 		default: return ArgType::NULL_T; break;
 	}
 }
@@ -180,41 +510,12 @@ char Argument::translateArgTypeToChar( ArgType type )
 		case ArgType::BOOL_F: return 'F'; break;
 		case ArgType::NULL_T: return 'N'; break;
 		case ArgType::INFINITUM: return 'I'; break;
+		case ArgType::ARRAY_BEGIN: return '['; break;
+		case ArgType::ARRAY_END: return ']'; break;
 		case ArgType::NONE: return 'N'; break;
 	}
 }
 
-void Argument::swapEndianForTransmit( uint8_t *buffer ) const
-{
-	auto ptr = &buffer[mOffset];
-	switch ( mType ) {
-		case ArgType::INTEGER_32:
-		case ArgType::CHAR:
-		case ArgType::BLOB: {
-			int32_t a = htonl( *reinterpret_cast<int32_t*>(ptr) );
-			memcpy( ptr, &a, sizeof( int32_t ) );
-		}
-			break;
-		case ArgType::INTEGER_64:
-		case ArgType::TIME_TAG: {
-			uint64_t a = htonll( *reinterpret_cast<uint64_t*>(ptr) );
-			memcpy( ptr, &a, sizeof( uint64_t ) );
-		}
-			break;
-		case ArgType::FLOAT: {
-			int32_t a = htonf( *reinterpret_cast<float*>(ptr) );
-			memcpy( ptr, &a, sizeof( float ) );
-		}
-			break;
-		case ArgType::DOUBLE: {
-			int64_t a = htond( *reinterpret_cast<double*>(ptr) );
-			memcpy( ptr, &a, sizeof( double ) );
-		}
-			break;
-		default: break;
-	}
-}
-
 void Argument::outputValueToStream( std::ostream &ostream ) const
 {
 	auto ptr = &mOwner->mDataBuffer[mOffset];
@@ -242,6 +543,8 @@ void Argument::outputValueToStream( std::ostream &ostream ) const
 		case ArgType::BOOL_F: ostream << "False"; break;
 		case ArgType::NULL_T: ostream << "Null"; break;
 		case ArgType::INFINITUM: ostream << "Infinitum"; break;
+		case ArgType::ARRAY_BEGIN: ostream << "["; break;
+		case ArgType::ARRAY_END: ostream << "]"; break;
 		default: ostream << "Unknown"; break;
 	}
 }
@@ -261,12 +564,21 @@ void Message::append( float v )
 }
 
 void Message::append( const std::string& v )
+{
+	append( v.data(), v.size() );
+}
+
+void Message::append( const char *v )
+{
+	append( v, strlen( v ) );
+}
+
+void Message::append( const char *v, size_t size )
 {
 	mIsCached = false;
-	auto trailingZeros = getTrailingZeros( v.size() );
-	auto size = v.size() + trailingZeros;
-	mDataViews.emplace_back( this, ArgType::STRING, getCurrentOffset(), size );
-	appendDataBuffer( v.data(), v.size(), trailingZeros );
+	auto trailingZeros = getTrailingZeros( size );
+	mDataViews.emplace_back( this, ArgType::STRING, getCurrentOffset(), size + trailingZeros );
+	appendDataBuffer( v, size, trailingZeros );
 }
 
 void Message::appendBlob( void* blob, uint32_t size )
@@ -340,45 +652,83 @@ void Message::appendMidi( uint8_t port, uint8_t status, uint8_t data1, uint8_t d
 	appendDataBuffer( b.data(), b.size() );
 }
 
-//void Message::appendArray( void* array, size_t size )
-//{
-//	if( !array || size == 0 ) return;
-//	mIsCached = false;
-//	mTypesArray.push_back( '[' );
-//	mTypesArray.insert( mTypesArray.end(), (uint8_t*) &array, (uint8_t*) &array + size );
-//	mTypesArray.push_back( ']' );
-//}
+void Message::appendFloats( const float *values, size_t count, bool asArray )
+{
+	appendArgRun( ArgType::FLOAT, values, sizeof( float ), count, asArray );
+}
 
-void Message::createCache() const
+void Message::appendInts( const int32_t *values, size_t count, bool asArray )
 {
-	std::string address( mAddress );
-	size_t addressLen = address.size() + getTrailingZeros( address.size() );
-	std::vector<uint8_t> dataArray( mDataBuffer );
-	std::vector<char> typesArray( mDataViews.size() + getTrailingZeros( mDataViews.size() ), 0 );
-	
-	typesArray[0] = ',';
-	int i = 1;
-	for( auto & dataView : mDataViews ) {
-		typesArray[i++] = Argument::translateArgTypeToChar( dataView.getType() );
-		if( dataView.needsEndianSwapForTransmit() )
-			dataView.swapEndianForTransmit( reinterpret_cast<uint8_t*>( dataArray.data() ) );
+	appendArgRun( ArgType::INTEGER_32, values, sizeof( int32_t ), count, asArray );
+}
+
+void Message::appendArgRun( ArgType type, const void *values, uint32_t size, size_t count, bool asArray )
+{
+	mIsCached = false;
+	mDataViews.reserve( mDataViews.size() + count + ( asArray ? 2 : 0 ) );
+	if( asArray )
+		mDataViews.emplace_back( this, ArgType::ARRAY_BEGIN, -1, 0 );
+	auto offset = getCurrentOffset();
+	for( size_t i = 0; i < count; i++ )
+		mDataViews.emplace_back( this, type, offset + i * size, size, true );
+	if( asArray )
+		mDataViews.emplace_back( this, ArgType::ARRAY_END, -1, 0 );
+	// the values stay in host order until they're swapped as a single run on encode.
+	appendDataBuffer( values, size * count );
+}
+
+size_t Message::encodedSize() const
+{
+	size_t addressLen = mAddress.size() + getTrailingZeros( mAddress.size() );
+	// the type tag is the ',' separator followed by a char per argument.
+	size_t typesLen = mDataViews.size() + 1;
+	typesLen += getTrailingZeros( typesLen );
+	return addressLen + typesLen + mDataBuffer.size();
+}
+
+size_t Message::encodeInto( uint8_t *buffer, size_t size ) const
+{
+	auto encodedLen = encodedSize();
+	if( ! buffer || size < encodedLen )
+		return 0;
+	
+	auto ptr = buffer;
+	// address
+	memcpy( ptr, mAddress.data(), mAddress.size() );
+	ptr += mAddress.size();
+	auto trailingZeros = getTrailingZeros( mAddress.size() );
+	memset( ptr, 0, trailingZeros );
+	ptr += trailingZeros;
+	
+	// type tag
+	*ptr++ = ',';
+	for( auto & dataView : mDataViews )
+		*ptr++ = Argument::translateArgTypeToChar( dataView.getType() );
+	trailingZeros = getTrailingZeros( mDataViews.size() + 1 );
+	memset( ptr, 0, trailingZeros );
+	ptr += trailingZeros;
+	
+	// arguments, swapped in place to big endian
+	if( ! mDataBuffer.empty() ) {
+		memcpy( ptr, mDataBuffer.data(), mDataBuffer.size() );
+		swapArgumentRuns( mDataViews.begin(), mDataViews.end(), ptr );
 	}
 	
-	if( ! mCache )
-		mCache = ByteBufferRef( new ByteBuffer() );
-	
-	size_t typesArrayLen = typesArray.size();
-	ByteArray<4> sizeArray;
-	int32_t messageSize = addressLen + typesArrayLen + mDataBuffer.size();
-	auto endianSize = htonl( messageSize );
-	memcpy( sizeArray.data(), reinterpret_cast<uint8_t*>( &endianSize ), 4 );
+	return encodedLen;
+}
+
+void Message::createCache() const
+{
+	// Reuse the cache's storage, unless a sender still holds onto it for an async send.
+	if( ! mCache || mCache.use_count() > 1 )
+		mCache = std::allocate_shared<ByteBuffer>( ResourceAllocator<ByteBuffer>( mResource ) );
 	
+	auto messageSize = encodedSize();
 	mCache->resize( 4 + messageSize );
 	
-	std::copy( sizeArray.begin(),	sizeArray.end(),	mCache->begin() );
-	std::copy( mAddress.begin(),	mAddress.end(),		mCache->begin() + 4 );
-	std::copy( typesArray.begin(),	typesArray.end(),	mCache->begin() + 4 + addressLen );
-	std::copy( dataArray.begin(),	dataArray.end(),	mCache->begin() + 4 + addressLen + typesArrayLen );
+	auto endianSize = htonl( static_cast<int32_t>( messageSize ) );
+	memcpy( mCache->data(), &endianSize, 4 );
+	encodeInto( mCache->data() + 4, messageSize );
 	mIsCached = true;
 }
 
@@ -401,7 +751,7 @@ const Argument& Message::getDataView( uint32_t index ) const
 void Message::appendDataBuffer( const void *begin, uint32_t size, uint32_t trailingZeros )
 {
 	auto ptr = reinterpret_cast<const uint8_t*>( begin );
-	mDataBuffer.insert( mDataBuffer.end(), ptr, ptr + size );
+	mDataBuffer.append( ptr, ptr + size );
 	if( trailingZeros != 0 )
 		mDataBuffer.resize( mDataBuffer.size() + trailingZeros, 0 );
 }
@@ -416,7 +766,9 @@ const Argument& Message::operator[]( uint32_t index ) const
 	
 bool Message::operator==( const Message &message ) const
 {
-	auto sameAddress = message.mAddress == mAddress;
+	// interned addresses compare by id.
+	auto sameAddress = mAddressId.isValid() && message.mAddressId.isValid() ? message.mAddressId == mAddressId
+																			: message.mAddress == mAddress;
 	if( ! sameAddress ) return false;
 	
 	auto sameDataViewSize = message.mDataViews.size() == mDataViews.size();
@@ -547,11 +899,43 @@ bool Argument::convertible() const
 		case ArgType::BOOL_F: return std::is_same<T, bool>::value;
 		case ArgType::NULL_T: return false;
 		case ArgType::INFINITUM: return false;
+		case ArgType::ARRAY_BEGIN: return false;
+		case ArgType::ARRAY_END: return false;
 		case ArgType::NONE: return false;
 		default: return false;
 	}
 }
 
+size_t Message::getFloats( uint32_t index, float *values, size_t count ) const
+{
+	return getArgRun( index, ArgType::FLOAT, values, sizeof( float ), count );
+}
+
+size_t Message::getInts( uint32_t index, int32_t *values, size_t count ) const
+{
+	return getArgRun( index, ArgType::INTEGER_32, values, sizeof( int32_t ), count );
+}
+
+size_t Message::getArgRun( uint32_t index, ArgType type, void *values, uint32_t size, size_t count ) const
+{
+	if( index >= mDataViews.size() )
+		throw ExcIndexOutOfBounds( mAddress, index );
+	
+	if( mDataViews[index].getType() == ArgType::ARRAY_BEGIN ) {
+		if( ++index == mDataViews.size() || mDataViews[index].getType() == ArgType::ARRAY_END )
+			return 0;
+	}
+	if( mDataViews[index].getType() != type )
+		throw ExcNonConvertible( mAddress, mDataViews[index].getType(), type );
+	
+	// fixed size arguments of the same type are stored back to back, copy them at once.
+	size_t found = 0;
+	while( found < count && index + found < mDataViews.size() && mDataViews[index + found].getType() == type )
+		found++;
+	memcpy( values, &mDataBuffer[mDataViews[index].getOffset()], found * size );
+	return found;
+}
+
 ArgType Message::getArgType( uint32_t index ) const
 {
 	if( index >= mDataViews.size() )
@@ -627,79 +1011,175 @@ void Message::getArgBlobData( uint32_t index, const void **dataPtr, size_t *size
 	dataView.blobData( dataPtr, size );
 }
 
-bool Message::bufferCache( uint8_t *data, size_t size )
+uint8_t* Message::getMutableCache()
+{
+	if( ! mIsCached )
+		return nullptr;
+	// Don't patch a buffer that a sender may still be transmitting asynchronously.
+	if( mCache.use_count() > 1 )
+		mCache = ByteBufferRef( new ByteBuffer( *mCache ) );
+	return mCache->data();
+}
+
+void Message::setArgData( uint32_t index, ArgType type, const void *data, const void *wireData, uint32_t size )
+{
+	if( index >= mDataViews.size() )
+		throw ExcIndexOutOfBounds( mAddress, index );
+	
+	auto &dataView = mDataViews[index];
+	if( dataView.getType() != type )
+		throw ExcNonConvertible( mAddress, dataView.getType(), type );
+	
+	memcpy( &mDataBuffer[dataView.getOffset()], data, size );
+	auto cache = getMutableCache();
+	if( cache ) {
+		// the arguments follow the size, address and type tag.
+		auto headerSize = 4 + encodedSize() - mDataBuffer.size();
+		memcpy( cache + headerSize + dataView.getOffset(), wireData, size );
+	}
+}
+
+void Message::setArg( uint32_t index, int32_t v )
+{
+	int32_t a = htonl( v );
+	setArgData( index, ArgType::INTEGER_32, &v, &a, sizeof( int32_t ) );
+}
+
+void Message::setArg( uint32_t index, float v )
+{
+	int32_t a = htonf( v );
+	setArgData( index, ArgType::FLOAT, &v, &a, sizeof( float ) );
+}
+
+void Message::setArg( uint32_t index, int64_t v )
+{
+	uint64_t a = htonll( static_cast<uint64_t>( v ) );
+	setArgData( index, ArgType::INTEGER_64, &v, &a, sizeof( int64_t ) );
+}
+
+void Message::setArg( uint32_t index, double v )
+{
+	int64_t a = htond( v );
+	setArgData( index, ArgType::DOUBLE, &v, &a, sizeof( double ) );
+}
+
+void Message::setArg( uint32_t index, char v )
+{
+	ByteArray<4> b, a;
+	b.fill( 0 );
+	a.fill( 0 );
+	b[0] = v;
+	a[3] = v;
+	setArgData( index, ArgType::CHAR, b.data(), a.data(), b.size() );
+}
+
+void Message::setArg( uint32_t index, bool v )
+{
+	if( index >= mDataViews.size() )
+		throw ExcIndexOutOfBounds( mAddress, index );
+	
+	auto &dataView = mDataViews[index];
+	if( dataView.getType() != ArgType::BOOL_T && dataView.getType() != ArgType::BOOL_F )
+		throw ExcNonConvertible( mAddress, dataView.getType(), ArgType::BOOL_T );
+	
+	dataView.mType = v ? ArgType::BOOL_T : ArgType::BOOL_F;
+	auto cache = getMutableCache();
+	if( cache ) {
+		// booleans only live in the type tag, which follows the size, address and ',' separator.
+		auto typeOffset = 4 + mAddress.size() + getTrailingZeros( mAddress.size() ) + 1 + index;
+		cache[typeOffset] = Argument::translateArgTypeToChar( dataView.mType );
+	}
+}
+
+void Message::setArgTime( uint32_t index, uint64_t v )
+{
+	uint64_t a = htonll( v );
+	setArgData( index, ArgType::TIME_TAG, &v, &a, sizeof( uint64_t ) );
+}
+
+void Message::setArgMidi( uint32_t index, uint8_t port, uint8_t status, uint8_t data1, uint8_t data2 )
+{
+	ByteArray<4> b;
+	b[0] = port;
+	b[1] = status;
+	b[2] = data1;
+	b[3] = data2;
+	setArgData( index, ArgType::MIDI, b.data(), b.data(), b.size() );
+}
+
+bool Message::bufferCache( const uint8_t *data, size_t size )
 {
-	uint8_t *head, *tail;
+	const uint8_t *head;
 	uint32_t i = 0;
 	size_t remain = size;
 	
 	// extract address
-	head = tail = data;
-	while( tail[i] != '\0' && ++i < remain );
+	head = data;
+	i = findNull( head, remain );
 	if( i == remain ) {
 		CI_LOG_E( "Problem Parsing Message: No address." );
 		return false;
 	}
 	
-	mAddress.insert( 0, (char*)head, i );
+	mAddress.assign( (const char*)head, i );
+	mAddressId = AddressId();
 	
 	head += i + getTrailingZeros( i );
-	remain = size - ( head - data );
-	
-	i = 0;
-	tail = head;
-	if( head[i++] != ',' ) {
+	if( head >= data + size || *head != ',' ) {
 		CI_LOG_E( "Problem Parsing Message: Mesage with address [" << mAddress << "] not properly formatted; no , seperator."  );
 		return false;
 	}
+	remain = size - ( head - data );
 	
 	// extract types
-	while( tail[i] != '\0' && ++i < remain );
+	i = 1 + findNull( head + 1, remain - 1 );
 	if( i == remain ) {
 		CI_LOG_E( "Problem Parsing Message:  Mesage with address [" << mAddress << "] not properly formatted; Types not complete." );
 		return false;
 	}
 	
-	std::vector<char> types( i - 1 );
-	std::copy( head + 1, head + i, types.begin() );
+	auto types = reinterpret_cast<const char*>( head + 1 );
+	size_t numTypes = i - 1;
 	head += i + getTrailingZeros( i );
+	if( head > data + size ) {
+		CI_LOG_E( "Problem Parsing Message:  Mesage with address [" << mAddress << "] not properly formatted; Types not complete." );
+		return false;
+	}
 	remain = size - ( head - data );
 	
-	// extract data
+	// extract data, still in big endian, which is swapped in a single pass below.
 	uint32_t int32;
-	uint64_t int64;
 	
-	mDataViews.resize( types.size() );
+	mDataViews.resize( numTypes );
 	int j = 0;
 	for( auto & dataView : mDataViews ) {
 		dataView.mOwner = this;
 		dataView.mType = Argument::translateCharToArgType( types[j] );
+		dataView.mNeedsEndianSwapForTransmit = getEndianSwapSize( dataView.mType ) != 0;
 		switch( types[j] ) {
 			case 'i':
 			case 'f':
 			case 'r': {
 				dataView.mSize = sizeof( uint32_t );
 				dataView.mOffset = getCurrentOffset();
-				memcpy( &int32, head, sizeof( uint32_t ) );
-				int32 = htonl( int32 );
-				appendDataBuffer( &int32, sizeof( uint32_t ) );
+				appendDataBuffer( head, sizeof( uint32_t ) );
 				head += sizeof( uint32_t );
 				remain -= sizeof( uint32_t );
 			}
 			break;
 			case 'b': {
 				memcpy( &int32, head, 4 );
-				head += 4;
-				remain -= 4;
-				int32 = htonl( int32 );
-				if( int32 > remain ) {
+				int32 = ntohl( int32 );
+				if( int32 > remain - 4 ) {
 					CI_LOG_E( "Problem Parsing Message:  Mesage with address [" << mAddress << "] not properly formatted; Blobs size is too long." );
 					return false;
 				}
 				auto trailingZeros = getTrailingZeros( int32 );
 				dataView.mSize = int32;
 				dataView.mOffset = getCurrentOffset();
-				appendDataBuffer( &dataView.mSize, sizeof( uint32_t ) );
+				appendDataBuffer( head, sizeof( uint32_t ) );
+				head += 4;
+				remain -= 4;
 				appendDataBuffer( head, int32, trailingZeros );
 				head += int32 + trailingZeros;
 				remain -= int32 + trailingZeros;
@@ -707,9 +1187,11 @@ bool Message::bufferCache( uint8_t *data, size_t size )
 			break;
 			case 's':
 			case 'S': {
-				tail = head;
-				i = 0;
-				while( tail[i] != '\0' && ++i < remain );
+				i = findNull( head, remain );
+				if( i == remain ) {
+					CI_LOG_E( "Problem Parsing Message:  Mesage with address [" << mAddress << "] not properly formatted; String not terminated." );
+					return false;
+				}
 				dataView.mSize = i + getTrailingZeros( i );
 				dataView.mOffset = getCurrentOffset();
 				appendDataBuffer( head, i, getTrailingZeros( i ) );
@@ -721,11 +1203,9 @@ bool Message::bufferCache( uint8_t *data, size_t size )
 			case 'h':
 			case 'd':
 			case 't': {
-				memcpy( &int64, head, sizeof( uint64_t ) );
-				int64 = htonll( int64 );
 				dataView.mSize = sizeof( uint64_t );
 				dataView.mOffset = getCurrentOffset();
-				appendDataBuffer( &int64, sizeof( uint64_t ) );
+				appendDataBuffer( head, sizeof( uint64_t ) );
 				head += sizeof( uint64_t );
 				remain -= sizeof( uint64_t );
 			}
@@ -733,9 +1213,7 @@ bool Message::bufferCache( uint8_t *data, size_t size )
 			case 'c': {
 				dataView.mSize = 4;
 				dataView.mOffset = getCurrentOffset();
-				memcpy( &int32, head, 4 );
-				auto character = (int) htonl( int32 );
-				appendDataBuffer( &character, 4 );
+				appendDataBuffer( head, 4 );
 				head += sizeof( int );
 				remain -= sizeof( int );
 			}
@@ -748,10 +1226,18 @@ bool Message::bufferCache( uint8_t *data, size_t size )
 				remain -= sizeof( int );
 			}
 				break;
+			case '[':
+			case ']': {
+				// array delimiters don't carry any data, the elements follow as regular arguments.
+				dataView.mSize = 0;
+				dataView.mOffset = -1;
+			}
+				break;
 		}
 		j++;
 	}
 	
+	swapArgumentRuns( mDataViews.begin(), mDataViews.end(), mDataBuffer.data() );
 	return true;
 }
 
@@ -759,24 +1245,39 @@ void Message::setAddress( const std::string& address )
 {
 	mIsCached = false;
 	mAddress = address;
+	mAddressId = AddressId();
 }
 
-size_t Message::size() const
+void Message::setAddress( const AddressId &address )
 {
-	if( ! mIsCached )
-		createCache();
-	return mCache->size();
+	mIsCached = false;
+	mAddress = address.getAddress();
+	mAddressId = address;
+}
+
+AddressId Message::getAddressId() const
+{
+	if( ! mAddressId.isValid() )
+		mAddressId = AddressId( mAddress );
+	return mAddressId;
 }
 
 void Message::clear()
 {
 	mIsCached = false;
 	mAddress.clear();
+	mAddressId = AddressId();
 	mDataViews.clear();
 	mDataBuffer.clear();
 	mCache.reset();
 }
 
+void Message::reserve( size_t dataSize, size_t numArgs )
+{
+	mDataBuffer.reserve( dataSize );
+	mDataViews.reserve( numArgs );
+}
+
 std::ostream& operator<<( std::ostream &os, const Message &rhs )
 {
 	os << "Address: " << rhs.getAddress() << std::endl;
@@ -789,52 +1290,463 @@ std::ostream& operator<<( std::ostream &os, const Message &rhs )
 }
 	
 ////////////////////////////////////////////////////////////////////////////////////////
-//// Bundle
+//// MessageView
 
-Bundle::Bundle()
-: mDataBuffer( new std::vector<uint8_t>( 20 ) )
+MessageView::MessageView( const uint8_t *data, size_t size )
+: mData( data ), mSize( size )
 {
-	static std::string id = "#bundle";
-	std::copy( id.begin(), id.end(), mDataBuffer->begin() + 4 );
-	(*mDataBuffer)[19] = 1;
 }
 
-void Bundle::setTimetag( uint64_t ntp_time )
+void MessageView::parseHeader() const
 {
-	uint64_t a = htonll( ntp_time );
-	ByteArray<8> b;
-	memcpy( b.data(), reinterpret_cast<uint8_t*>( &a ), 8 );
-	mDataBuffer->insert( mDataBuffer->begin() + 12, b.begin(), b.end() );
+	if( mIsParsed )
+		return;
+	mIsParsed = true;
+	
+	size_t addressLength = findNull( mData, mSize );
+	if( addressLength == mSize )
+		return;
+	
+	size_t typesOffset = addressLength + Message::getTrailingZeros( addressLength );
+	if( typesOffset >= mSize || mData[typesOffset] != ',' )
+		return;
+	// the type tag length, including the ',' seperator.
+	size_t typesLength = findNull( mData + typesOffset, mSize - typesOffset );
+	if( typesOffset + typesLength == mSize )
+		return;
+	size_t argsOffset = typesOffset + typesLength + Message::getTrailingZeros( typesLength );
+	if( argsOffset > mSize )
+		return;
+	
+	mAddressLength = addressLength;
+	mTypes = reinterpret_cast<const char*>( mData + typesOffset + 1 );
+	mNumArgs = typesLength - 1;
+	mArgsOffset = mCursorOffset = argsOffset;
+	mIsValid = true;
 }
 
-void Bundle::appendData( const ByteBufferRef& data )
+bool MessageView::isValid() const
 {
-	// Size is already the first 4 bytes of every message.
-	mDataBuffer->insert( mDataBuffer->end(), data->begin(), data->end() );
+	parseHeader();
+	return mIsValid;
 }
 
-ByteBufferRef Bundle::getSharedBuffer() const
+const char* MessageView::getAddress() const
 {
-	int32_t a = htonl( size() - 4 );
-	memcpy( mDataBuffer->data(), reinterpret_cast<uint8_t*>( &a ), 4 );
-	return mDataBuffer;
+	parseHeader();
+	return mIsValid ? reinterpret_cast<const char*>( mData ) : "";
 }
-	
-////////////////////////////////////////////////////////////////////////////////////////
-//// SenderBase
-	
-void SenderBase::setSocketTransportErrorFn( SocketTransportErrorFn errorFn )
+
+size_t MessageView::getAddressLength() const
 {
-	std::lock_guard<std::mutex> lock( mSocketErrorFnMutex );
-	mSocketTransportErrorFn = errorFn;
+	parseHeader();
+	return mAddressLength;
 }
 
-////////////////////////////////////////////////////////////////////////////////////////
-//// SenderUdp
-
-SenderUdp::SenderUdp( uint16_t localPort, const std::string &destinationHost, uint16_t destinationPort, const protocol &protocol, asio::io_service &service )
-: mSocket( new udp::socket( service ) ), mLocalEndpoint( protocol, localPort ),
-	mRemoteEndpoint( udp::endpoint( address::from_string( destinationHost ), destinationPort ) )
+size_t MessageView::getNumArgs() const
+{
+	parseHeader();
+	return mNumArgs;
+}
+
+ArgType MessageView::getArgType( uint32_t index ) const
+{
+	if( index >= getNumArgs() )
+		throw ExcIndexOutOfBounds( getAddress(), index );
+	
+	return Argument::translateCharToArgType( mTypes[index] );
+}
+
+size_t MessageView::getArgSize( uint32_t index, size_t offset ) const
+{
+	size_t remain = mSize - offset;
+	switch( mTypes[index] ) {
+		case 'i':
+		case 'f':
+		case 'r':
+		case 'c':
+		case 'm': return 4;
+		case 'h':
+		case 'd':
+		case 't': return 8;
+		case 's':
+		case 'S': {
+			size_t length = findNull( mData + offset, remain );
+			if( length == remain )
+				throw ExcIndexOutOfBounds( getAddress(), index );
+			return length + Message::getTrailingZeros( length );
+		}
+		case 'b': {
+			if( remain < 4 )
+				throw ExcIndexOutOfBounds( getAddress(), index );
+			uint32_t blobSize;
+			memcpy( &blobSize, mData + offset, 4 );
+			blobSize = ntohl( blobSize );
+			return 4 + size_t( blobSize ) + Message::getTrailingZeros( blobSize );
+		}
+		default: return 0;
+	}
+}
+
+size_t MessageView::getArgOffset( uint32_t index ) const
+{
+	uint32_t cursorIndex = mCursorIndex;
+	size_t cursorOffset = mCursorOffset;
+	if( index < cursorIndex ) {
+		cursorIndex = 0;
+		cursorOffset = mArgsOffset;
+	}
+	while( cursorIndex < index ) {
+		cursorOffset += getArgSize( cursorIndex, cursorOffset );
+		if( cursorOffset > mSize )
+			throw ExcIndexOutOfBounds( getAddress(), index );
+		cursorIndex++;
+	}
+	mCursorIndex = cursorIndex;
+	mCursorOffset = cursorOffset;
+	return cursorOffset;
+}
+
+const uint8_t* MessageView::getArgData( uint32_t index, ArgType type ) const
+{
+	auto actualType = getArgType( index );
+	bool convertible = actualType == type;
+	switch( type ) {
+		case ArgType::INTEGER_32:
+			convertible |= actualType == ArgType::CHAR || actualType == ArgType::MIDI;
+		break;
+		case ArgType::INTEGER_64:
+			convertible |= actualType == ArgType::TIME_TAG;
+		break;
+		case ArgType::BOOL_T:
+			convertible |= actualType == ArgType::BOOL_F;
+		break;
+		default: break;
+	}
+	if( ! convertible )
+		throw ExcNonConvertible( getAddress(), actualType, type );
+	
+	auto offset = getArgOffset( index );
+	if( offset + getArgSize( index, offset ) > mSize )
+		throw ExcIndexOutOfBounds( getAddress(), index );
+	return mData + offset;
+}
+
+int32_t MessageView::getArgInt( uint32_t index ) const
+{
+	uint32_t v;
+	memcpy( &v, getArgData( index, ArgType::INTEGER_32 ), sizeof( uint32_t ) );
+	return (int32_t) ntohl( v );
+}
+
+float MessageView::getArgFloat( uint32_t index ) const
+{
+	uint32_t v;
+	memcpy( &v, getArgData( index, ArgType::FLOAT ), sizeof( uint32_t ) );
+	v = ntohl( v );
+	float f;
+	memcpy( &f, &v, sizeof( float ) );
+	return f;
+}
+
+const char* MessageView::getArgString( uint32_t index ) const
+{
+	return reinterpret_cast<const char*>( getArgData( index, ArgType::STRING ) );
+}
+
+int64_t MessageView::getArgTime( uint32_t index ) const
+{
+	return getArgInt64( index );
+}
+
+int64_t MessageView::getArgInt64( uint32_t index ) const
+{
+	uint64_t v;
+	memcpy( &v, getArgData( index, ArgType::INTEGER_64 ), sizeof( uint64_t ) );
+	return (int64_t) ntohll( v );
+}
+
+double MessageView::getArgDouble( uint32_t index ) const
+{
+	uint64_t v;
+	memcpy( &v, getArgData( index, ArgType::DOUBLE ), sizeof( uint64_t ) );
+	v = ntohll( v );
+	double d;
+	memcpy( &d, &v, sizeof( double ) );
+	return d;
+}
+
+bool MessageView::getArgBool( uint32_t index ) const
+{
+	getArgData( index, ArgType::BOOL_T );
+	return mTypes[index] == 'T';
+}
+
+char MessageView::getArgChar( uint32_t index ) const
+{
+	// chars are sent as a big endian int32, whose last byte holds the value.
+	return (char) getArgData( index, ArgType::INTEGER_32 )[3];
+}
+
+void MessageView::getArgMidi( uint32_t index, uint8_t *port, uint8_t *status, uint8_t *data1, uint8_t *data2 ) const
+{
+	auto data = getArgData( index, ArgType::INTEGER_32 );
+	*port = data[0];
+	*status = data[1];
+	*data1 = data[2];
+	*data2 = data[3];
+}
+
+void MessageView::getArgBlobData( uint32_t index, const void **dataPtr, size_t *size ) const
+{
+	auto data = getArgData( index, ArgType::BLOB );
+	uint32_t blobSize;
+	memcpy( &blobSize, data, 4 );
+	*size = ntohl( blobSize );
+	*dataPtr = data + 4;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+//// MessageTemplate
+
+MessageTemplate::MessageTemplate( const Message &prototype )
+: mAddress( prototype.getAddress() ), mCache( new ByteBuffer( prototype.size() ) )
+{
+	auto messageSize = prototype.encodedSize();
+	auto endianSize = htonl( static_cast<int32_t>( messageSize ) );
+	memcpy( mCache->data(), &endianSize, 4 );
+	prototype.encodeInto( mCache->data() + 4, messageSize );
+	
+	size_t addressLen = mAddress.size() + Message::getTrailingZeros( mAddress.size() );
+	size_t typesLen = prototype.mDataViews.size() + 1;
+	typesLen += Message::getTrailingZeros( typesLen );
+	// skip the size and the ',' separator.
+	uint32_t typeOffset = 4 + addressLen + 1;
+	uint32_t dataOffset = 4 + addressLen + typesLen;
+	
+	mSlots.reserve( prototype.mDataViews.size() );
+	for( auto & dataView : prototype.mDataViews ) {
+		auto type = dataView.getType();
+		if( type == ArgType::BOOL_T || type == ArgType::BOOL_F )
+			mSlots.push_back( { type, typeOffset } );
+		else
+			mSlots.push_back( { type, dataOffset + dataView.getOffset() } );
+		typeOffset++;
+	}
+}
+
+const MessageTemplate::Slot& MessageTemplate::getSlot( uint32_t index, ArgType type ) const
+{
+	if( index >= mSlots.size() )
+		throw ExcIndexOutOfBounds( mAddress, index );
+	
+	auto &slot = mSlots[index];
+	auto slotType = slot.mType == ArgType::BOOL_F ? ArgType::BOOL_T : slot.mType;
+	if( slotType != type )
+		throw ExcNonConvertible( mAddress, slot.mType, type );
+	return slot;
+}
+
+void MessageTemplate::write( uint32_t offset, const void *data, size_t size )
+{
+	// Don't patch a buffer that a sender may still be transmitting asynchronously.
+	if( mCache.use_count() > 1 )
+		mCache = ByteBufferRef( new ByteBuffer( *mCache ) );
+	memcpy( mCache->data() + offset, data, size );
+}
+
+void MessageTemplate::set( uint32_t index, int32_t v )
+{
+	auto &slot = getSlot( index, ArgType::INTEGER_32 );
+	int32_t a = htonl( v );
+	write( slot.mOffset, &a, sizeof( int32_t ) );
+}
+
+void MessageTemplate::set( uint32_t index, float v )
+{
+	auto &slot = getSlot( index, ArgType::FLOAT );
+	int32_t a = htonf( v );
+	write( slot.mOffset, &a, sizeof( float ) );
+}
+
+void MessageTemplate::set( uint32_t index, int64_t v )
+{
+	auto &slot = getSlot( index, ArgType::INTEGER_64 );
+	uint64_t a = htonll( static_cast<uint64_t>( v ) );
+	write( slot.mOffset, &a, sizeof( int64_t ) );
+}
+
+void MessageTemplate::set( uint32_t index, double v )
+{
+	auto &slot = getSlot( index, ArgType::DOUBLE );
+	int64_t a = htond( v );
+	write( slot.mOffset, &a, sizeof( double ) );
+}
+
+void MessageTemplate::set( uint32_t index, char v )
+{
+	auto &slot = getSlot( index, ArgType::CHAR );
+	ByteArray<4> b;
+	b.fill( 0 );
+	b[3] = v;
+	write( slot.mOffset, b.data(), b.size() );
+}
+
+void MessageTemplate::set( uint32_t index, bool v )
+{
+	getSlot( index, ArgType::BOOL_T );
+	auto &slot = mSlots[index];
+	slot.mType = v ? ArgType::BOOL_T : ArgType::BOOL_F;
+	char type = v ? 'T' : 'F';
+	write( slot.mOffset, &type, 1 );
+}
+
+void MessageTemplate::setTimeTag( uint32_t index, uint64_t v )
+{
+	auto &slot = getSlot( index, ArgType::TIME_TAG );
+	uint64_t a = htonll( v );
+	write( slot.mOffset, &a, sizeof( uint64_t ) );
+}
+
+void MessageTemplate::setMidi( uint32_t index, uint8_t port, uint8_t status, uint8_t data1, uint8_t data2 )
+{
+	auto &slot = getSlot( index, ArgType::MIDI );
+	ByteArray<4> b;
+	b[0] = port;
+	b[1] = status;
+	b[2] = data1;
+	b[3] = data2;
+	write( slot.mOffset, b.data(), b.size() );
+}
+
+ArgType MessageTemplate::getArgType( uint32_t index ) const
+{
+	if( index >= mSlots.size() )
+		throw ExcIndexOutOfBounds( mAddress, index );
+	
+	return mSlots[index].mType;
+}
+	
+////////////////////////////////////////////////////////////////////////////////////////
+//// Bundle
+
+Bundle::Bundle( MemoryResource *resource )
+: mBuffers( resource ), mSize( sHeaderSize ), mResource( resource )
+{
+	auto header = std::allocate_shared<ByteBuffer>( ResourceAllocator<ByteBuffer>( resource ), sHeaderSize, uint8_t( 0 ) );
+	static std::string id = "#bundle";
+	std::copy( id.begin(), id.end(), header->begin() + 4 );
+	(*header)[19] = 1;
+	mBuffers.push_back( header );
+	updateHeaderSize();
+}
+
+uint8_t* Bundle::getMutableHeader()
+{
+	auto &header = mBuffers.front();
+	if( header.use_count() > 1 )
+		header = std::allocate_shared<ByteBuffer>( ResourceAllocator<ByteBuffer>( mResource ), *header );
+	return header->data();
+}
+
+void Bundle::updateHeaderSize()
+{
+	int32_t a = htonl( static_cast<int32_t>( mSize - 4 ) );
+	memcpy( getMutableHeader(), &a, 4 );
+}
+
+void Bundle::setTimetag( uint64_t ntp_time )
+{
+	uint64_t a = htonll( ntp_time );
+	memcpy( getMutableHeader() + 12, &a, 8 );
+}
+
+void Bundle::append( const Bundle &bundle )
+{
+	auto &buffers = bundle.getSharedBuffers();
+	// The nested header is small, copy it so later changes to that bundle don't affect this one.
+	mBuffers.push_back( std::allocate_shared<ByteBuffer>( ResourceAllocator<ByteBuffer>( mResource ), *buffers.front() ) );
+	mBuffers.insert( mBuffers.end(), buffers.begin() + 1, buffers.end() );
+	mSize += bundle.size();
+	updateHeaderSize();
+}
+
+void Bundle::appendData( const ByteBufferRef& data )
+{
+	// Size is already the first 4 bytes of every message.
+	mBuffers.push_back( data );
+	mSize += data->size();
+	updateHeaderSize();
+}
+
+void Bundle::clear()
+{
+	mBuffers.resize( 1 );
+	mSize = sHeaderSize;
+	updateHeaderSize();
+}
+	
+////////////////////////////////////////////////////////////////////////////////////////
+//// SenderBase
+	
+void SenderBase::setSocketTransportErrorFn( SocketTransportErrorFn errorFn )
+{
+	std::lock_guard<std::mutex> lock( mSocketErrorFnMutex );
+	mSocketTransportErrorFn = errorFn;
+}
+
+void SenderBase::sendImpl( const ByteBufferList &byteBuffers )
+{
+	size_t size = 0;
+	for( auto & byteBuffer : byteBuffers )
+		size += byteBuffer->size();
+	
+	auto data = ByteBufferRef( new ByteBuffer() );
+	data->reserve( size );
+	for( auto & byteBuffer : byteBuffers )
+		data->insert( data->end(), byteBuffer->begin(), byteBuffer->end() );
+	sendImpl( data );
+}
+
+void SenderBase::send( const Message *messages, size_t count )
+{
+	std::lock_guard<std::mutex> lock( mBatchMutex );
+	for( size_t i = 0; i < count; i++ )
+		mBatchBuffers.push_back( messages[i].getSharedBuffer() );
+	sendBatchImpl( mBatchBuffers );
+	// don't hold onto the caches, so the messages can be updated in place.
+	mBatchBuffers.clear();
+}
+
+void SenderBase::sendBatchImpl( const ByteBufferList &byteBuffers )
+{
+	for( auto & byteBuffer : byteBuffers )
+		sendImpl( byteBuffer );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+//// SenderUdp
+
+#if defined( __linux__ )
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+
+struct SenderUdp::BatchState {
+	//! The most datagrams submitted with one call, which is also the kernel's limit of segments.
+	static const size_t sMaxBatch = 64;
+	
+	std::array<mmsghdr, sMaxBatch>	mMessages;
+	std::array<iovec, sMaxBatch>	mIovecs;
+	std::array<uint8_t, CMSG_SPACE( sizeof( uint16_t ) )> mControl;
+};
+#else
+struct SenderUdp::BatchState {};
+#endif
+
+SenderUdp::SenderUdp( uint16_t localPort, const std::string &destinationHost, uint16_t destinationPort, const protocol &protocol, asio::io_service &service )
+: mSocket( new udp::socket( service ) ), mLocalEndpoint( protocol, localPort ),
+	mRemoteEndpoint( udp::endpoint( address::from_string( destinationHost ), destinationPort ) )
 {
 }
 	
@@ -866,7 +1778,7 @@ void SenderUdp::sendImpl( const ByteBufferRef &data )
 			// derive oscAddress
 			std::string oscAddress;
 			if( ! data->empty() )
-				oscAddress = std::string( (const char*)(data.get() + 4) );
+				oscAddress = std::string( (const char*)(data->data() + 4) );
 			
 			std::lock_guard<std::mutex> lock( mSocketErrorFnMutex );
 			if( mSocketTransportErrorFn ) {
@@ -878,6 +1790,251 @@ void SenderUdp::sendImpl( const ByteBufferRef &data )
 	});
 }
 	
+void SenderUdp::sendImpl( const ByteBufferList &data )
+{
+	// asio only hands the first 64 buffers of a sequence to a single datagram send, so larger
+	// bundles are gathered with sendmsg, or copied into a single buffer where that's unavailable.
+	if( data.size() > 64 ) {
+#if defined( __linux__ )
+		if( data.size() <= IOV_MAX ) {
+			sendGathered( data );
+			return;
+		}
+#endif
+		SenderBase::sendImpl( data );
+		return;
+	}
+	
+	std::vector<asio::const_buffer> buffers;
+	buffers.reserve( data.size() );
+	// the header's first 4 bytes(int) comprise the size of the buffer, which datagram doesn't need.
+	buffers.push_back( asio::buffer( data.front()->data() + 4, data.front()->size() - 4 ) );
+	for( auto it = data.begin() + 1; it != data.end(); ++it )
+		buffers.push_back( asio::buffer( **it ) );
+	
+	mSocket->async_send_to( buffers, mRemoteEndpoint,
+	// copy data pointers to persist the asynchronous send
+	[&, data]( const asio::error_code& error, size_t /*bytesTransferred*/ )
+	{
+		if( error ) {
+			// derive oscAddress
+			std::string oscAddress( (const char*)(data.front()->data() + 4) );
+			
+			std::lock_guard<std::mutex> lock( mSocketErrorFnMutex );
+			if( mSocketTransportErrorFn ) {
+				mSocketTransportErrorFn( error, oscAddress );
+			}
+			else
+				CI_LOG_E( error.message() << ", didn't send message [" << oscAddress << "] to " << mRemoteEndpoint.address().to_string() );
+		}
+	});
+}
+	
+void SenderUdp::sendBatchImpl( const ByteBufferList &data )
+{
+#if defined( __linux__ )
+	// queue behind the datagrams still waiting for the socket, so they all arrive in order.
+	if( ! mPendingBatch.empty() ) {
+		mPendingBatch.insert( mPendingBatch.end(), data.begin(), data.end() );
+		return;
+	}
+	
+	auto sent = sendBatch( data );
+	if( sent < data.size() ) {
+		mPendingBatch.assign( data.begin() + sent, data.end() );
+		sendPendingBatch();
+	}
+#else
+	SenderBase::sendBatchImpl( data );
+#endif
+}
+
+size_t SenderUdp::sendBatch( const ByteBufferList &data )
+{
+	if( ! mBatchState )
+		mBatchState = std::make_shared<BatchState>();
+	
+	size_t sent = 0;
+	while( sent < data.size() ) {
+		size_t count = mUseSegmentation ? sendSegmented( data, sent ) : 0;
+		if( count == 0 )
+			count = sendMultiple( data, sent );
+		if( count == 0 )
+			break;
+		sent += count;
+	}
+	return sent;
+}
+
+void SenderUdp::sendPendingBatch()
+{
+	// only wait for the socket to be writable, the datagrams are sent by sendBatch.
+	mSocket->async_send_to( asio::null_buffers(), mRemoteEndpoint,
+	[&]( const asio::error_code &error, size_t /*bytesTransferred*/ )
+	{
+		std::lock_guard<std::mutex> lock( mBatchMutex );
+		if( error ) {
+			for( auto & data : mPendingBatch )
+				handleSendError( error, data );
+			mPendingBatch.clear();
+			return;
+		}
+		
+		auto sent = sendBatch( mPendingBatch );
+		mPendingBatch.erase( mPendingBatch.begin(), mPendingBatch.begin() + sent );
+		if( ! mPendingBatch.empty() )
+			sendPendingBatch();
+	});
+}
+
+size_t SenderUdp::sendSegmented( const ByteBufferList &data, size_t first )
+{
+#if defined( __linux__ )
+	// the datagrams of a segmented send have to fit in a single UDP packet.
+	const size_t maxPayload = 65507;
+	// data's first 4 bytes(int) comprise the size of the buffer, which datagram doesn't need.
+	const size_t segmentSize = data[first]->size() - 4;
+	size_t count = 0;
+	while( first + count < data.size() && count < BatchState::sMaxBatch
+		  && data[first + count]->size() - 4 == segmentSize && ( count + 1 ) * segmentSize <= maxPayload ) {
+		auto &iov = mBatchState->mIovecs[count];
+		iov.iov_base = data[first + count]->data() + 4;
+		iov.iov_len = segmentSize;
+		count++;
+	}
+	if( count < 2 )
+		return 0;
+	
+	msghdr header;
+	memset( &header, 0, sizeof( header ) );
+	header.msg_name = mRemoteEndpoint.data();
+	header.msg_namelen = mRemoteEndpoint.size();
+	header.msg_iov = mBatchState->mIovecs.data();
+	header.msg_iovlen = count;
+	header.msg_control = mBatchState->mControl.data();
+	header.msg_controllen = mBatchState->mControl.size();
+	auto cmsg = CMSG_FIRSTHDR( &header );
+	cmsg->cmsg_level = SOL_UDP;
+	cmsg->cmsg_type = UDP_SEGMENT;
+	cmsg->cmsg_len = CMSG_LEN( sizeof( uint16_t ) );
+	uint16_t gsoSize = uint16_t( segmentSize );
+	memcpy( CMSG_DATA( cmsg ), &gsoSize, sizeof( uint16_t ) );
+	
+	if( sendmsg( mSocket->native_handle(), &header, MSG_DONTWAIT ) < 0 ) {
+		switch( errno ) {
+			case EAGAIN:
+#if EWOULDBLOCK != EAGAIN
+			case EWOULDBLOCK:
+#endif
+				// the socket is full, the caller queues the datagrams.
+				return 0;
+			case EINVAL:
+			case EIO:
+			case ENOPROTOOPT:
+			case EOPNOTSUPP:
+				// segmentation isn't supported by the kernel or the device, stop trying.
+				mUseSegmentation = false;
+				return 0;
+			default: {
+				asio::error_code error( errno, asio::error::get_system_category() );
+				for( size_t i = 0; i < count; i++ )
+					handleSendError( error, data[first + i] );
+			}
+			break;
+		}
+	}
+	return count;
+#else
+	return 0;
+#endif
+}
+
+size_t SenderUdp::sendMultiple( const ByteBufferList &data, size_t first )
+{
+#if defined( __linux__ )
+	size_t count = std::min( data.size() - first, BatchState::sMaxBatch );
+	for( size_t i = 0; i < count; i++ ) {
+		auto &iov = mBatchState->mIovecs[i];
+		iov.iov_base = data[first + i]->data() + 4;
+		iov.iov_len = data[first + i]->size() - 4;
+		auto &header = mBatchState->mMessages[i].msg_hdr;
+		memset( &header, 0, sizeof( header ) );
+		header.msg_name = mRemoteEndpoint.data();
+		header.msg_namelen = mRemoteEndpoint.size();
+		header.msg_iov = &iov;
+		header.msg_iovlen = 1;
+	}
+	
+	int sent = sendmmsg( mSocket->native_handle(), mBatchState->mMessages.data(), (unsigned int) count, MSG_DONTWAIT );
+	if( sent > 0 )
+		return sent;
+	// the socket is full, the caller queues the datagrams.
+	if( errno == EAGAIN || errno == EWOULDBLOCK )
+		return 0;
+	// nothing was sent, the error belongs to the first datagram.
+	handleSendError( asio::error_code( errno, asio::error::get_system_category() ), data[first] );
+	return 1;
+#else
+	sendImpl( data[first] );
+	return 1;
+#endif
+}
+
+void SenderUdp::sendGathered( const ByteBufferList &data )
+{
+#if defined( __linux__ )
+	std::vector<iovec> iovecs( data.size() );
+	for( size_t i = 0; i < data.size(); i++ ) {
+		iovecs[i].iov_base = data[i]->data();
+		iovecs[i].iov_len = data[i]->size();
+	}
+	// the header's first 4 bytes(int) comprise the size of the buffer, which datagram doesn't need.
+	iovecs[0].iov_base = data[0]->data() + 4;
+	iovecs[0].iov_len -= 4;
+	
+	msghdr header;
+	memset( &header, 0, sizeof( header ) );
+	header.msg_name = mRemoteEndpoint.data();
+	header.msg_namelen = mRemoteEndpoint.size();
+	header.msg_iov = iovecs.data();
+	header.msg_iovlen = iovecs.size();
+	if( sendmsg( mSocket->native_handle(), &header, MSG_DONTWAIT ) >= 0 )
+		return;
+	
+	if( errno == EAGAIN || errno == EWOULDBLOCK ) {
+		// the socket is full, wait until it's writable and try again.
+		mSocket->async_send_to( asio::null_buffers(), mRemoteEndpoint,
+		// copy data pointers to persist the asynchronous send
+		[&, data]( const asio::error_code &error, size_t /*bytesTransferred*/ )
+		{
+			if( error )
+				handleSendError( error, data.front() );
+			else
+				sendGathered( data );
+		});
+	}
+	else
+		handleSendError( asio::error_code( errno, asio::error::get_system_category() ), data.front() );
+#else
+	SenderBase::sendImpl( data );
+#endif
+}
+
+void SenderUdp::handleSendError( const asio::error_code &error, const ByteBufferRef &data )
+{
+	// derive oscAddress
+	std::string oscAddress;
+	if( ! data->empty() )
+		oscAddress = std::string( (const char*)(data->data() + 4) );
+	
+	std::lock_guard<std::mutex> lock( mSocketErrorFnMutex );
+	if( mSocketTransportErrorFn ) {
+		mSocketTransportErrorFn( error, oscAddress );
+	}
+	else
+		CI_LOG_E( error.message() << ", didn't send message [" << oscAddress << "] to " << mRemoteEndpoint.address().to_string() );
+}
+
 void SenderUdp::closeImpl()
 {
 	mSocket->close();
@@ -910,90 +2067,870 @@ void SenderTcp::bindImpl()
 	mSocket->bind( mLocalEndpoint );
 }
 	
-void SenderTcp::connect()
+void SenderTcp::connect()
+{
+	mSocket->async_connect( mRemoteEndpoint,
+	[&]( const asio::error_code &error ){
+		if( error )
+			CI_LOG_E( error.message() );
+	});
+}
+
+void SenderTcp::sendImpl( const ByteBufferRef &data )
+{
+	mSocket->async_send( asio::buffer( *data ),
+	// copy data pointer to persist the asynchronous send
+	[&, data]( const asio::error_code& error, size_t bytesTransferred )
+	{
+		if( error ) {
+			// derive oscAddress
+			std::string oscAddress;
+			if( ! data->empty() )
+				oscAddress = std::string( (const char*)(data->data() + 4) );
+			
+			std::lock_guard<std::mutex> lock( mSocketErrorFnMutex );
+			if( mSocketTransportErrorFn ) {
+				mSocketTransportErrorFn( error, oscAddress );
+			}
+			else
+				CI_LOG_E( error.message() << ", didn't send message [" << oscAddress << "] to " << mRemoteEndpoint.address().to_string() );
+		}
+	});
+}
+	
+void SenderTcp::sendImpl( const ByteBufferList &data )
+{
+	std::vector<asio::const_buffer> buffers;
+	buffers.reserve( data.size() );
+	for( auto & byteBuffer : data )
+		buffers.push_back( asio::buffer( *byteBuffer ) );
+	
+	asio::async_write( *mSocket, buffers,
+	// copy data pointers to persist the asynchronous send
+	[&, data]( const asio::error_code& error, size_t /*bytesTransferred*/ )
+	{
+		if( error ) {
+			// derive oscAddress
+			std::string oscAddress( (const char*)(data.front()->data() + 4) );
+			
+			std::lock_guard<std::mutex> lock( mSocketErrorFnMutex );
+			if( mSocketTransportErrorFn ) {
+				mSocketTransportErrorFn( error, oscAddress );
+			}
+			else
+				CI_LOG_E( error.message() << ", didn't send message [" << oscAddress << "] to " << mRemoteEndpoint.address().to_string() );
+		}
+	});
+}
+	
+/////////////////////////////////////////////////////////////////////////////////////////
+//// DispatchPool
+
+DispatchPool::DispatchPool( size_t numThreads )
+{
+	numThreads = std::max<size_t>( numThreads, 1 );
+	for( size_t i = 0; i < numThreads; ++i ) {
+		mWorkers.emplace_back( new Worker );
+		auto &worker = *mWorkers.back();
+		worker.mThread = std::thread( [this, &worker] { run( worker ); } );
+	}
+}
+
+DispatchPool::~DispatchPool()
+{
+	for( auto & worker : mWorkers ) {
+		{
+			std::lock_guard<std::mutex> lock( worker->mMutex );
+			worker->mIsStopping = true;
+		}
+		worker->mCondition.notify_one();
+	}
+	for( auto & worker : mWorkers )
+		worker->mThread.join();
+}
+
+void DispatchPool::post( uint64_t key, std::function<void()> task )
+{
+	auto &worker = *mWorkers[key % mWorkers.size()];
+	{
+		std::lock_guard<std::mutex> lock( worker.mMutex );
+		worker.mTasks.push_back( std::move( task ) );
+	}
+	worker.mCondition.notify_one();
+}
+
+void DispatchPool::run( Worker &worker )
+{
+	std::unique_lock<std::mutex> lock( worker.mMutex );
+	while( true ) {
+		worker.mCondition.wait( lock, [&worker] { return worker.mIsStopping || ! worker.mTasks.empty(); } );
+		if( worker.mTasks.empty() )
+			return;
+		auto task = std::move( worker.mTasks.front() );
+		worker.mTasks.pop_front();
+		lock.unlock();
+		task();
+		lock.lock();
+	}
+}
+	
+/////////////////////////////////////////////////////////////////////////////////////////
+//// StateTable
+
+StateTable::StateTable( const std::vector<std::string> &addresses, size_t maxMessageSize )
+: mSlots( new Slot[addresses.size()] ), mNumSlots( addresses.size() ),
+	mNumWords( ( maxMessageSize + 7 ) / 8 ), mFrame( 0 )
+{
+	for( size_t i = 0; i < mNumSlots; ++i ) {
+		auto &slot = mSlots[i];
+		slot.mAddress = addresses[i];
+		slot.mSequence.store( 0, std::memory_order_relaxed );
+		slot.mFrame.store( 0, std::memory_order_relaxed );
+		slot.mSize.store( 0, std::memory_order_relaxed );
+		slot.mWords.reset( new std::atomic<uint64_t>[mNumWords] );
+		mSlotIndices.emplace( addresses[i], i );
+	}
+}
+
+size_t StateTable::getSlot( const std::string &address ) const
+{
+	auto found = mSlotIndices.find( address );
+	return found != mSlotIndices.end() ? found->second : npos;
+}
+
+bool StateTable::write( size_t slotIndex, const uint8_t *data, size_t size )
+{
+	if( size > mNumWords * 8 )
+		return false;
+	// writers of the same slot, i.e. the shards of a receiver, take turns by making the sequence
+	// odd. Writers of other slots don't wait.
+	auto &slot = mSlots[slotIndex];
+	auto sequence = slot.mSequence.load( std::memory_order_relaxed );
+	while( true ) {
+		if( sequence & 1 ) {
+			std::this_thread::yield();
+			sequence = slot.mSequence.load( std::memory_order_relaxed );
+		}
+		else if( slot.mSequence.compare_exchange_weak( sequence, sequence + 1, std::memory_order_acquire, std::memory_order_relaxed ) )
+			break;
+	}
+	std::atomic_thread_fence( std::memory_order_release );
+	for( size_t i = 0; i * 8 < size; ++i ) {
+		uint64_t word = 0;
+		memcpy( &word, data + i * 8, std::min<size_t>( 8, size - i * 8 ) );
+		slot.mWords[i].store( word, std::memory_order_relaxed );
+	}
+	slot.mSize.store( static_cast<uint32_t>( size ), std::memory_order_relaxed );
+	// the frame is taken while the slot is odd, so a reader that has seen the frame either waits
+	// for this write or reads it, and is never told of it again.
+	auto frame = mFrame.fetch_add( 1, std::memory_order_acq_rel ) + 1;
+	slot.mFrame.store( frame, std::memory_order_release );
+	slot.mSequence.store( sequence + 2, std::memory_order_release );
+	return true;
+}
+
+bool StateTable::read( size_t slotIndex, Message &message, uint64_t *frame ) const
+{
+	// typical messages are copied to the stack, larger slots to a buffer that's reused.
+	if( mNumWords <= 64 ) {
+		uint64_t words[64];
+		return readWords( slotIndex, message, words, frame );
+	}
+	static thread_local std::vector<uint64_t> words;
+	return read( slotIndex, message, words, frame );
+}
+
+bool StateTable::read( size_t slotIndex, Message &message, std::vector<uint64_t> &words, uint64_t *frame ) const
+{
+	if( words.size() < mNumWords )
+		words.resize( mNumWords );
+	return readWords( slotIndex, message, words.data(), frame );
+}
+
+bool StateTable::readWords( size_t slotIndex, Message &message, uint64_t *words, uint64_t *frame ) const
+{
+	auto &slot = mSlots[slotIndex];
+	uint32_t sequence, size;
+	uint64_t writeFrame;
+	while( true ) {
+		sequence = slot.mSequence.load( std::memory_order_acquire );
+		if( sequence & 1 ) {
+			std::this_thread::yield();
+			continue;
+		}
+		if( ! sequence )
+			return false;
+		size = slot.mSize.load( std::memory_order_relaxed );
+		writeFrame = slot.mFrame.load( std::memory_order_relaxed );
+		for( size_t i = 0; i * 8 < size; ++i )
+			words[i] = slot.mWords[i].load( std::memory_order_relaxed );
+		std::atomic_thread_fence( std::memory_order_acquire );
+		// a write that overlapped the copy changed the sequence, so try again.
+		if( slot.mSequence.load( std::memory_order_relaxed ) == sequence )
+			break;
+	}
+	if( frame )
+		*frame = writeFrame;
+	message.clear();
+	return message.bufferCache( reinterpret_cast<const uint8_t*>( words ), size );
+}
+
+bool StateTable::hasChangedSince( size_t slot, uint64_t frame ) const
+{
+	return mSlots[slot].mFrame.load( std::memory_order_acquire ) > frame;
+}
+
+void StateTable::getChangedSince( uint64_t frame, std::vector<size_t> &slots ) const
+{
+	slots.clear();
+	for( size_t i = 0; i < mNumSlots; ++i ) {
+		if( hasChangedSince( i, frame ) )
+			slots.push_back( i );
+	}
+}
+	
+/////////////////////////////////////////////////////////////////////////////////////////
+//// ReceiverBase
+	
+void ReceiverBase::setListener( ListenerTable &table, const std::string &address, ListenerFn listener, ListenerTable::Dispatch dispatch )
+{
+	auto foundListener = std::find_if( table.mListeners.begin(), table.mListeners.end(),
+	[&address]( const std::pair<std::string, ListenerFn> &listener ) {
+		  return address == listener.first;
+	});
+	if( foundListener != table.mListeners.end() ) {
+		foundListener->second = listener;
+		table.mDispatches[foundListener - table.mListeners.begin()] = dispatch;
+	}
+	else {
+		table.mListeners.push_back( { address, listener } );
+		table.mDispatches.push_back( dispatch );
+	}
+}
+
+void ReceiverBase::setListener( const std::string &address, ListenerFn listener )
+{
+	setListener( address, listener, Execution::INLINE );
+}
+
+void ReceiverBase::setListener( const std::string &address, ListenerFn listener, Execution execution )
+{
+	if( execution == Execution::EXECUTOR ) {
+		CI_LOG_E( "Listener for " << address << " needs an Executor, running it inline." );
+		execution = Execution::INLINE;
+	}
+	updateListeners( [&]( ListenerTable &table ) {
+		setListener( table, address, listener, { execution, nullptr } );
+	});
+}
+
+void ReceiverBase::setListener( const std::string &address, ListenerFn listener, Executor executor )
+{
+	auto execution = executor ? Execution::EXECUTOR : Execution::INLINE;
+	updateListeners( [&]( ListenerTable &table ) {
+		setListener( table, address, listener, { execution, executor } );
+	});
+}
+
+void ReceiverBase::setListeners( const Listeners &listeners )
+{
+	updateListeners( [&]( ListenerTable &table ) {
+		for( auto & listener : listeners )
+			setListener( table, listener.first, listener.second, { Execution::INLINE, nullptr } );
+	});
+}
+
+void ReceiverBase::setDispatchPool( DispatchPoolRef pool )
+{
+	updateListeners( [&]( ListenerTable &table ) {
+		table.mDispatchPool = pool;
+	});
+}
+
+void ReceiverBase::removeListener( const std::string &address )
+{
+	updateListeners( [&]( ListenerTable &table ) {
+		auto foundListener = std::find_if( table.mListeners.begin(), table.mListeners.end(),
+		[address]( const std::pair<std::string, ListenerFn> &listener ) {
+			  return address == listener.first;
+		});
+		if( foundListener != table.mListeners.end() ) {
+			table.mDispatches.erase( table.mDispatches.begin() + ( foundListener - table.mListeners.begin() ) );
+			table.mListeners.erase( foundListener );
+		}
+	});
+}
+
+void ReceiverBase::setViewListener( const std::string &address, ViewListenerFn listener )
+{
+	updateListeners( [&]( ListenerTable &table ) {
+		auto foundListener = std::find_if( table.mViewListeners.begin(), table.mViewListeners.end(),
+		[address]( const std::pair<std::string, ViewListenerFn> &listener ) {
+			  return address == listener.first;
+		});
+		if( foundListener != table.mViewListeners.end() ) {
+			foundListener->second = listener;
+		}
+		else {
+			table.mViewListeners.push_back( { address, listener } );
+		}
+	});
+}
+
+void ReceiverBase::removeViewListener( const std::string &address )
+{
+	updateListeners( [&]( ListenerTable &table ) {
+		auto foundListener = std::find_if( table.mViewListeners.begin(), table.mViewListeners.end(),
+		[address]( const std::pair<std::string, ViewListenerFn> &listener ) {
+			  return address == listener.first;
+		});
+		if( foundListener != table.mViewListeners.end() ) {
+			table.mViewListeners.erase( foundListener );
+		}
+	});
+}
+
+void ReceiverBase::setPolling( size_t capacity )
+{
+	updateListeners( [&]( ListenerTable &table ) {
+		table.mPollQueue.reset( capacity ? new PollQueue( capacity ) : nullptr );
+	});
+}
+
+size_t ReceiverBase::poll( const ListenerFn &fn, size_t maxCount )
+{
+	loadListenerTable( mPollScratch );
+	auto &queue = mPollScratch.mListenerTable->mPollQueue;
+	if( ! queue )
+		return 0;
+	size_t count = 0;
+	Message *message;
+	while( count < maxCount && ( message = queue->front() ) ) {
+		fn( *message );
+		queue->pop();
+		++count;
+	}
+	return count;
+}
+
+size_t ReceiverBase::poll( size_t maxCount )
+{
+	loadListenerTable( mPollScratch );
+	auto &table = *mPollScratch.mListenerTable;
+	if( ! table.mPollQueue )
+		return 0;
+	size_t count = 0;
+	Message *message;
+	while( count < maxCount && ( message = table.mPollQueue->front() ) ) {
+		auto &matches = resolveAddress( message->mAddress.data(), message->mAddress.size(), mPollScratch );
+		for( auto index : matches.mListeners )
+			table.mListeners[index].second( *message );
+		table.mPollQueue->pop();
+		++count;
+	}
+	return count;
+}
+
+void ReceiverBase::setStateTable( StateTableRef table )
+{
+	updateListeners( [&]( ListenerTable &listenerTable ) {
+		listenerTable.mStateTable = table;
+	});
+}
+
+size_t ReceiverBase::getNumDroppedMessages() const
+{
+	auto table = std::atomic_load( &mListenerTable );
+	return table->mPollQueue ? table->mPollQueue->mNumDropped.load( std::memory_order_relaxed ) : 0;
+}
+
+void ReceiverBase::updateListeners( const std::function<void( ListenerTable &table )> &update )
+{
+	std::lock_guard<std::mutex> lock( mListenerMutex );
+	auto current = std::atomic_load( &mListenerTable );
+	std::shared_ptr<ListenerTable> table( new ListenerTable );
+	table->mListeners = current->mListeners;
+	table->mDispatches = current->mDispatches;
+	table->mViewListeners = current->mViewListeners;
+	table->mDispatchPool = current->mDispatchPool;
+	table->mPollQueue = current->mPollQueue;
+	table->mStateTable = current->mStateTable;
+	update( *table );
+	buildAddressTrie( *table );
+	std::atomic_store( &mListenerTable, ListenerTableRef( table ) );
+	mListenersVersion.fetch_add( 1, std::memory_order_release );
+}
+
+ReceiverBase::SegmentMatcher::SegmentMatcher( const std::string &pattern )
+{
+	mIsCompiled = compile( pattern );
+}
+
+bool ReceiverBase::SegmentMatcher::compile( const std::string &pattern )
+{
+	// the chars accepted at each position, folded into classes at the end.
+	std::vector<std::bitset<256>> accepts;
+	mFollow.clear();
+	mFirst = 0;
+	// the positions that may end the part compiled so far, and whether that part may be empty.
+	uint64_t last = 0;
+	bool isNullable = true;
+	
+	auto addPosition = [&]() -> uint64_t {
+		accepts.emplace_back();
+		mFollow.push_back( 0 );
+		return uint64_t( 1 ) << ( accepts.size() - 1 );
+	};
+	// chains an item, starting at the positions first and ending at itemLast, to the part compiled so far.
+	auto appendItem = [&]( uint64_t first, uint64_t itemLast, bool itemNullable ) {
+		for( uint64_t rest = last; rest; rest &= rest - 1 )
+			mFollow[getLowestSetBit( rest )] |= first;
+		if( isNullable )
+			mFirst |= first;
+		last = itemNullable ? ( last | itemLast ) : itemLast;
+		isNullable = isNullable && itemNullable;
+	};
+	
+	mIsValid = false;
+	const char *it = pattern.data(), *end = it + pattern.size();
+	while( it != end ) {
+		if( accepts.size() == sMaxPositions )
+			return false;
+		switch( *it ) {
+			case '?':
+			case '*': {
+				auto position = addPosition();
+				accepts.back().set();
+				bool isStar = *it == '*';
+				if( isStar )
+					mFollow.back() |= position;
+				appendItem( position, position, isStar );
+				++it;
+			}
+				break;
+			case '[': {
+				bool negate = false;
+				if( ++it != end && *it == '!' ) {
+					negate = true;
+					++it;
+				}
+				auto position = addPosition();
+				auto &chars = accepts.back();
+				while( it != end && *it != ']' ) {
+					if( end - it > 2 && it[1] == '-' && it[2] != ']' ) {
+						auto start = uint8_t( it[0] ), stop = uint8_t( it[2] );
+						if( start > stop )
+							std::swap( start, stop );
+						for( uint32_t c = start; c <= stop; ++c )
+							chars.set( c );
+						it += 3;
+					}
+					else
+						chars.set( uint8_t( *it++ ) );
+				}
+				// malformed, matches nothing.
+				if( it == end )
+					return true;
+				if( negate )
+					chars.flip();
+				appendItem( position, position, false );
+				++it;
+			}
+				break;
+			case '{': {
+				uint64_t first = 0, groupLast = 0;
+				bool groupNullable = false;
+				do {
+					// every alternative is a run of literal chars.
+					uint64_t previous = 0;
+					while( ++it != end && *it != ',' && *it != '}' ) {
+						if( accepts.size() == sMaxPositions )
+							return false;
+						auto position = addPosition();
+						accepts.back().set( uint8_t( *it ) );
+						if( previous )
+							mFollow[getLowestSetBit( previous )] |= position;
+						else
+							first |= position;
+						previous = position;
+					}
+					if( previous )
+						groupLast |= previous;
+					else
+						groupNullable = true;
+				} while( it != end && *it == ',' );
+				if( it == end )
+					return true;
+				appendItem( first, groupLast, groupNullable );
+				++it;
+			}
+				break;
+			default: {
+				auto position = addPosition();
+				accepts.back().set( uint8_t( *it ) );
+				appendItem( position, position, false );
+				++it;
+			}
+				break;
+		}
+	}
+	mLast = last;
+	mIsNullable = isNullable;
+	mIsValid = true;
+	mPrefix.assign( pattern.begin(), std::find_if( pattern.begin(), pattern.end(), []( char c ) {
+		return c == '*' || c == '?' || c == '[' || c == '{';
+	}) );
+	
+	// chars accepted at the same positions share a class, so the table stays small.
+	mClassPositions.clear();
+	for( uint32_t c = 0; c < 256; ++c ) {
+		uint64_t positions = 0;
+		for( size_t i = 0; i < accepts.size(); ++i ) {
+			if( accepts[i].test( c ) )
+				positions |= uint64_t( 1 ) << i;
+		}
+		auto found = std::find( mClassPositions.begin(), mClassPositions.end(), positions );
+		mClassOf[c] = uint8_t( found - mClassPositions.begin() );
+		if( found == mClassPositions.end() )
+			mClassPositions.push_back( positions );
+	}
+	return true;
+}
+
+bool ReceiverBase::SegmentMatcher::match( const char *segment, size_t length ) const
+{
+	if( ! mIsValid )
+		return false;
+	if( ! length )
+		return mIsNullable;
+	// most segments are told apart by their literal start already.
+	if( length < mPrefix.size() || memcmp( segment, mPrefix.data(), mPrefix.size() ) )
+		return false;
+	uint64_t state = mFirst & mClassPositions[mClassOf[uint8_t( segment[0] )]];
+	for( size_t i = 1; i < length && state; ++i ) {
+		uint64_t next = 0;
+		for( uint64_t rest = state; rest; rest &= rest - 1 )
+			next |= mFollow[getLowestSetBit( rest )];
+		state = next & mClassPositions[mClassOf[uint8_t( segment[i] )]];
+	}
+	return ( state & mLast ) != 0;
+}
+
+namespace {
+
+//! Splits \a address on '/' into \a segments, so that "/a/b" becomes "", "a" and "b".
+void splitAddress( const char *address, size_t length, std::vector<std::pair<const char*, size_t>> &segments )
+{
+	segments.clear();
+	const char *begin = address, *end = address + length;
+	for( const char *it = address; it != end; ++it ) {
+		if( *it == '/' ) {
+			segments.emplace_back( begin, it - begin );
+			begin = it + 1;
+		}
+	}
+	segments.emplace_back( begin, end - begin );
+}
+
+//! Returns whether \a segment has any of the OSC pattern chars.
+bool hasWildcard( const char *segment, size_t length )
+{
+	for( size_t i = 0; i < length; ++i ) {
+		switch( segment[i] ) {
+			case '*': case '?': case '[': case ']': case '{': case '}': return true;
+			default: break;
+		}
+	}
+	return false;
+}
+	
+//! Binary searches the sorted \a children for the literal \a segment of \a length chars.
+template<typename Children>
+typename Children::const_iterator findLiteral( const Children &children, const char *segment, size_t length )
 {
-	mSocket->async_connect( mRemoteEndpoint,
-	[&]( const asio::error_code &error ){
-		if( error )
-			CI_LOG_E( error.message() );
+	auto found = std::lower_bound( children.begin(), children.end(), std::make_pair( segment, length ),
+	[]( const typename Children::value_type &child, const std::pair<const char*, size_t> &key ) {
+		return child.first.compare( 0, std::string::npos, key.first, key.second ) < 0;
 	});
+	if( found != children.end() && ! found->first.compare( 0, std::string::npos, segment, length ) )
+		return found;
+	return children.end();
+}
+	
+} // anonymous namespace
+	
+void ReceiverBase::insertListener( ListenerTable &table, const std::string &address, uint32_t index, bool isView,
+									std::vector<std::pair<const char*, size_t>> &segments )
+{
+	splitAddress( address.data(), address.size(), segments );
+	auto node = &table.mAddressTrie;
+	for( auto & segment : segments ) {
+		std::string key( segment.first, segment.second );
+		AddressNode::Child *child = nullptr;
+		if( hasWildcard( segment.first, segment.second ) ) {
+			auto &children = node->mPatternChildren;
+			auto found = std::find_if( children.begin(), children.end(),
+			[&key]( const AddressNode::Child &child ) {
+				return child.first == key;
+			});
+			if( found == children.end() ) {
+				children.emplace_back( key, std::unique_ptr<AddressNode>( new AddressNode ) );
+				found = children.end() - 1;
+				found->second->mMatcher.reset( new SegmentMatcher( key ) );
+			}
+			child = &*found;
+		}
+		else {
+			auto &children = node->mChildren;
+			// addresses are inserted in sorted order, so new children mostly go at the end.
+			if( children.empty() || children.back().first < key ) {
+				children.emplace_back( key, std::unique_ptr<AddressNode>( new AddressNode ) );
+				child = &children.back();
+			}
+			else {
+				auto found = std::lower_bound( children.begin(), children.end(), key,
+				[]( const AddressNode::Child &child, const std::string &key ) {
+					return child.first < key;
+				});
+				if( found == children.end() || found->first != key )
+					found = children.emplace( found, key, std::unique_ptr<AddressNode>( new AddressNode ) );
+				child = &*found;
+			}
+		}
+		node = child->second.get();
+	}
+	( isView ? node->mViewListeners : node->mListeners ).push_back( index );
+	if( ! isView && table.mDispatches[index].mAddressId.isValid() )
+		node->mAddressId = table.mDispatches[index].mAddressId;
 }
 
-void SenderTcp::sendImpl( const ByteBufferRef &data )
+void ReceiverBase::buildAddressTrie( ListenerTable &table )
 {
-	mSocket->async_send( asio::buffer( *data ),
-	// copy data pointer to persist the asynchronous send
-	[&, data]( const asio::error_code& error, size_t bytesTransferred )
-	{
-		if( error ) {
-			// derive oscAddress
-			std::string oscAddress;
-			if( ! data->empty() )
-				oscAddress = std::string( (const char*)(data.get() + 4) );
-			
-			std::lock_guard<std::mutex> lock( mSocketErrorFnMutex );
-			if( mSocketTransportErrorFn ) {
-				mSocketTransportErrorFn( error, oscAddress );
-			}
-			else
-				CI_LOG_E( error.message() << ", didn't send message [" << oscAddress << "] to " << mRemoteEndpoint.address().to_string() );
-		}
+	// inserting in address order keeps a node with thousands of children from shifting them on
+	// every insert. Dispatch sorts the listeners it finds back into registration order.
+	std::vector<uint32_t> order( table.mListeners.size() );
+	for( size_t i = 0; i < order.size(); ++i )
+		order[i] = static_cast<uint32_t>( i );
+	std::sort( order.begin(), order.end(),
+	[&table]( uint32_t lhs, uint32_t rhs ) {
+		return table.mListeners[lhs].first < table.mListeners[rhs].first;
 	});
+	std::vector<std::pair<const char*, size_t>> segments;
+	for( auto i : order ) {
+		auto &address = table.mListeners[i].first;
+		// only registered addresses have an id, incoming ones would grow the interned table forever.
+		auto &addressId = table.mDispatches[i].mAddressId;
+		if( ! addressId.isValid() && ! hasWildcard( address.data(), address.size() ) )
+			addressId = AddressId( address );
+		insertListener( table, address, i, false, segments );
+	}
+	for( size_t i = 0; i < table.mViewListeners.size(); ++i )
+		insertListener( table, table.mViewListeners[i].first, static_cast<uint32_t>( i ), true, segments );
 }
-	
-/////////////////////////////////////////////////////////////////////////////////////////
-//// ReceiverBase
-	
-void ReceiverBase::setListener( const std::string &address, ListenerFn listener )
+
+void ReceiverBase::matchListeners( const AddressNode &node, DecodeScratch &scratch, size_t depth ) const
 {
-	std::lock_guard<std::mutex> lock( mListenerMutex );
-	auto foundListener = std::find_if( mListeners.begin(), mListeners.end(),
-	[address]( const std::pair<std::string, ListenerFn> &listener ) {
-		  return address == listener.first;
-	});
-	if( foundListener != mListeners.end() ) {
-		foundListener->second = listener;
+	if( depth == scratch.mSegments.size() ) {
+		auto &matches = scratch.mMatches;
+		matches.mListeners.insert( matches.mListeners.end(), node.mListeners.begin(), node.mListeners.end() );
+		matches.mViewListeners.insert( matches.mViewListeners.end(), node.mViewListeners.begin(), node.mViewListeners.end() );
+		if( node.mAddressId.isValid() )
+			matches.mAddressId = node.mAddressId;
+		return;
+	}
+	auto segment = scratch.mSegments[depth];
+	if( hasWildcard( segment.first, segment.second ) ) {
+		// the incoming address is a pattern itself, match it against the registered segments.
+		for( auto & child : node.mChildren ) {
+			if( patternMatch( child.first.data(), child.first.size(), segment.first, segment.second ) )
+				matchListeners( *child.second, scratch, depth + 1 );
+		}
+		for( auto & child : node.mPatternChildren ) {
+			if( ! child.first.compare( 0, std::string::npos, segment.first, segment.second ) )
+				matchListeners( *child.second, scratch, depth + 1 );
+		}
 	}
 	else {
-		mListeners.push_back( { address, listener } );
+		auto found = findLiteral( node.mChildren, segment.first, segment.second );
+		if( found != node.mChildren.end() )
+			matchListeners( *found->second, scratch, depth + 1 );
+		for( auto & child : node.mPatternChildren ) {
+			auto &matcher = *child.second->mMatcher;
+			bool matches = matcher.isCompiled() ? matcher.match( segment.first, segment.second )
+												: patternMatch( segment.first, segment.second, child.first.data(), child.first.size() );
+			if( matches )
+				matchListeners( *child.second, scratch, depth + 1 );
+		}
 	}
 }
 
-void ReceiverBase::removeListener( const std::string &address )
-{
-	std::lock_guard<std::mutex> lock( mListenerMutex );
-	auto foundListener = std::find_if( mListeners.begin(), mListeners.end(),
-	[address]( const std::pair<std::string, ListenerFn> &listener ) {
-		  return address == listener.first;
+const ReceiverBase::AddressMatches& ReceiverBase::resolveAddress( const char *address, size_t length, DecodeScratch &scratch ) const
+{
+	auto &cache = scratch.mAddressCache;
+	scratch.mAddressKey.assign( address, length );
+	auto cached = cache.find( scratch.mAddressKey );
+	if( cached != cache.end() )
+		return cached->second;
+	
+	auto &matches = scratch.mMatches;
+	auto &table = *scratch.mListenerTable;
+	matches.mListeners.clear();
+	matches.mDeferredListeners.clear();
+	matches.mViewListeners.clear();
+	matches.mAddressId = AddressId();
+	splitAddress( address, length, scratch.mSegments );
+	matchListeners( table.mAddressTrie, scratch, 0 );
+	// call listeners in the order they were registered.
+	std::sort( matches.mListeners.begin(), matches.mListeners.end() );
+	std::sort( matches.mViewListeners.begin(), matches.mViewListeners.end() );
+	// move the listeners that don't run inline aside, POOL ones run inline without a pool.
+	auto deferred = std::stable_partition( matches.mListeners.begin(), matches.mListeners.end(),
+	[&table]( uint32_t index ) {
+		auto execution = table.mDispatches[index].mExecution;
+		return execution == Execution::INLINE || ( execution == Execution::POOL && ! table.mDispatchPool );
 	});
-	if( foundListener != mListeners.end() ) {
-		mListeners.erase( foundListener );
+	matches.mDeferredListeners.assign( deferred, matches.mListeners.end() );
+	matches.mListeners.erase( deferred, matches.mListeners.end() );
+	matches.mStateSlot = table.mStateTable ? table.mStateTable->getSlot( scratch.mAddressKey ) : StateTable::npos;
+	// cached addresses without listeners are only reported the first time around. Polled messages
+	// may well be handled without listeners.
+	if( matches.mListeners.empty() && matches.mDeferredListeners.empty() && matches.mViewListeners.empty()
+	   && ! table.mPollQueue && matches.mStateSlot == StateTable::npos ) {
+		CI_LOG_W("Message: " << scratch.mAddressKey << " doesn't have a listener. Disregarding.");
 	}
+	// an incoming pattern may reach literal listener addresses, but isn't one of them.
+	if( hasWildcard( address, length ) )
+		matches.mAddressId = AddressId();
+	if( cache.size() < sMaxCachedAddresses )
+		return cache.emplace( scratch.mAddressKey, matches ).first->second;
+	return matches;
+}
+
+void ReceiverBase::setDecodeArena( MemoryResource *resource )
+{
+	mDecodeScratch.mViews = MessageViewList( resource );
+	mDecodeScratch.mMessage = Message( resource, std::string() );
 }
 
-void ReceiverBase::dispatchMethods( uint8_t *data, uint32_t size )
+void ReceiverBase::dispatchMethods( uint8_t *data, uint32_t size, DecodeScratch &scratch )
 {
-	std::vector<Message> messages;
-	decodeData( data, size, messages );
-	if( messages.empty() ) return;
+	auto &views = scratch.mViews;
+	views.clear();
+	decodeData( data, size, views );
 	
-	std::lock_guard<std::mutex> lock( mListenerMutex );
+	// listeners changed from here on, by a listener too, are seen from the next packet on.
+	loadListenerTable( scratch );
+	// the scratch holds onto the table, so no lock is needed while listeners run.
+	auto &table = *scratch.mListenerTable;
 	// iterate through all the messages and find matches with registered methods
-	for( auto & message : messages ) {
-		bool dispatchedOnce = false;
-		for( auto & listener : mListeners ) {
-			if( patternMatch( message.getAddress(), listener.first ) ) {
-				listener.second( message );
-				dispatchedOnce = true;
+	for( auto & view : views ) {
+		auto &matches = resolveAddress( view.getAddress(), view.getAddressLength(), scratch );
+		if( matches.mStateSlot != StateTable::npos )
+			table.mStateTable->write( matches.mStateSlot, view.data(), view.size() );
+		for( auto index : matches.mViewListeners )
+			table.mViewListeners[index].second( view );
+		if( ! matches.mDeferredListeners.empty() )
+			dispatchDeferred( view, matches, scratch );
+		if( table.mPollQueue ) {
+			auto &queue = *table.mPollQueue;
+			auto message = queue.beginPush();
+			if( ! message ) {
+				queue.mNumDropped.fetch_add( 1, std::memory_order_relaxed );
+				continue;
 			}
+			bool decoded = decodeMessage( view, *message, scratch );
+			if( decoded )
+				message->mAddressId = matches.mAddressId;
+			queue.endPush( decoded );
+			continue;
 		}
-		if( ! dispatchedOnce ) {
-			CI_LOG_W("Message: " << message.getAddress() << " doesn't have a listener. Disregarding.");
+		// only decode into a Message when a listener asks for one, and then only once. The decoder
+		// reports any problem itself.
+		if( ! matches.mListeners.empty() && decodeMessage( view, scratch.mMessage, scratch ) ) {
+			scratch.mMessage.mAddressId = matches.mAddressId;
+			for( auto index : matches.mListeners )
+				table.mListeners[index].second( scratch.mMessage );
 		}
 	}
 }
+
+void ReceiverBase::loadListenerTable( DecodeScratch &scratch ) const
+{
+	// the table is only loaded when it's changed, which empties the address cache.
+	auto version = mListenersVersion.load( std::memory_order_acquire );
+	if( ! scratch.mListenerTable || scratch.mListenersVersion != version ) {
+		scratch.mListenerTable = std::atomic_load( &mListenerTable );
+		scratch.mListenersVersion = version;
+		scratch.mAddressCache.clear();
+	}
+}
+
+ReceiverBase::PollQueue::PollQueue( size_t capacity )
+: mHead( 0 ), mTail( 0 ), mNumDropped( 0 ), mIsPushing( false ), mReportedConcurrentPush( false )
+{
+	size_t size = 1;
+	while( size < capacity )
+		size <<= 1;
+	mSlots.reset( new Message[size] );
+	mMask = size - 1;
+}
+
+Message* ReceiverBase::PollQueue::beginPush()
+{
+	if( mIsPushing.exchange( true, std::memory_order_acquire ) ) {
+		if( ! mReportedConcurrentPush.exchange( true, std::memory_order_relaxed ) )
+			CI_LOG_E( "Polled messages are dispatched from several threads at once, dropping them. Run the io_service on a single thread." );
+		return nullptr;
+	}
+	auto tail = mTail.load( std::memory_order_relaxed );
+	if( tail - mHead.load( std::memory_order_acquire ) > mMask ) {
+		mIsPushing.store( false, std::memory_order_release );
+		return nullptr;
+	}
+	return &mSlots[tail & mMask];
+}
+
+void ReceiverBase::PollQueue::endPush( bool publish )
+{
+	if( publish )
+		mTail.store( mTail.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+	mIsPushing.store( false, std::memory_order_release );
+}
+
+Message* ReceiverBase::PollQueue::front()
+{
+	auto head = mHead.load( std::memory_order_relaxed );
+	if( head == mTail.load( std::memory_order_acquire ) )
+		return nullptr;
+	return &mSlots[head & mMask];
+}
+
+void ReceiverBase::PollQueue::pop()
+{
+	mHead.store( mHead.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+}
+
+void ReceiverBase::dispatchDeferred( const MessageView &view, const AddressMatches &matches, DecodeScratch &scratch ) const
+{
+	// the listeners run after the receive buffer and the scratch have moved on, so they share a copy.
+	std::shared_ptr<Message> message( new Message );
+	if( ! decodeMessage( view, *message, scratch ) )
+		return;
+	message->mAddressId = matches.mAddressId;
+	auto &table = *scratch.mListenerTable;
+	auto key = hashAddressBytes( view.getAddress(), view.getAddressLength() );
+	for( auto index : matches.mDeferredListeners ) {
+		auto &dispatch = table.mDispatches[index];
+		auto listener = table.mListeners[index].second;
+		auto task = [listener, message] { listener( *message ); };
+		if( dispatch.mExecution == Execution::POOL )
+			table.mDispatchPool->post( key, task );
+		else
+			dispatch.mExecutor( task );
+	}
+}
 	
-bool ReceiverBase::decodeData( uint8_t *data, uint32_t size, std::vector<Message> &messages, uint64_t timetag ) const
+bool ReceiverBase::decodeData( uint8_t *data, uint32_t size, MessageViewList &views, uint64_t timetag ) const
 {
 	if( ! memcmp( data, "#bundle\0", 8 ) ) {
 		data += 8; size -= 8;
@@ -1011,39 +2948,157 @@ bool ReceiverBase::decodeData( uint8_t *data, uint32_t size, std::vector<Message
 				CI_LOG_E( "Problem Parsing Bundle: Segment Size is greater than bundle size." );
 				return false;
 			}
-			if( !decodeData( data, seg_size, messages, ntohll( timestamp ) ) )
+			if( !decodeData( data, seg_size, views, ntohll( timestamp ) ) )
 				return false;
 			
 			data += seg_size; size -= seg_size;
 		}
 	}
 	else {
-		if( ! decodeMessage( data, size, messages, timetag ) )
+		MessageView view( data, size );
+		if( ! view.isValid() ) {
+			CI_LOG_E( "Problem Parsing Message: Address or types not properly formatted." );
 			return false;
+		}
+		views.push_back( view );
 	}
 	
 	return true;
 }
 
-bool ReceiverBase::decodeMessage( uint8_t *data, uint32_t size, std::vector<Message> &messages, uint64_t timetag ) const
+bool ReceiverBase::decodeMessage( const MessageView &view, Message &message, DecodeScratch &scratch ) const
 {
-	Message message;
-	if( ! message.bufferCache( data, size ) )
+	message.clear();
+	auto plan = findDecodePlan( scratch, view.mTypes, view.mNumArgs );
+	if( ! plan || ! plan->mIsFixed )
+		return message.bufferCache( view.data(), view.size() );
+	
+	if( view.size() - view.mArgsOffset < plan->mArgsSize ) {
+		CI_LOG_E( "Problem Parsing Message: Mesage with address [" << view.getAddress() << "] not properly formatted; Arguments not complete." );
 		return false;
+	}
 	
-	messages.push_back( std::move( message ) );
+	// all offsets are known, copy the arguments at once and swap them run by run.
+	message.mAddress.assign( view.getAddress(), view.getAddressLength() );
+	auto args = view.data() + view.mArgsOffset;
+	message.mDataBuffer.append( args, args + plan->mArgsSize );
+	for( auto & arg : plan->mArgs )
+		message.mDataViews.emplace_back( &message, arg.mType, arg.mOffset, arg.mSize, arg.mNeedsSwap );
+	auto data = message.mDataBuffer.data();
+	for( auto & run : plan->mSwapRuns ) {
+		if( run.mSize == 4 )
+			swapEndian32( data + run.mOffset, run.mCount );
+		else
+			swapEndian64( data + run.mOffset, run.mCount );
+	}
 	return true;
 }
 
+//! Increments a counter that only the calling thread writes, without a locked read-modify-write.
+static inline void incrementCounter( std::atomic<size_t> &counter )
+{
+	counter.store( counter.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+}
+
+const ReceiverBase::DecodePlan* ReceiverBase::findDecodePlan( DecodeScratch &scratch, const char *types, size_t numTypes ) const
+{
+	auto &plans = scratch.mPlans;
+	auto matches = [types, numTypes]( const DecodePlan &plan ) {
+		return plan.mTypes.size() == numTypes && ! memcmp( plan.mTypes.data(), types, numTypes );
+	};
+	// streams tend to repeat the same signature, try the last one first.
+	if( scratch.mLastPlan < plans.size() && matches( plans[scratch.mLastPlan] ) ) {
+		incrementCounter( scratch.mPlanHits );
+		return &plans[scratch.mLastPlan];
+	}
+	for( size_t i = 0; i < plans.size(); i++ ) {
+		if( matches( plans[i] ) ) {
+			scratch.mLastPlan = i;
+			incrementCounter( scratch.mPlanHits );
+			return &plans[i];
+		}
+	}
+	
+	incrementCounter( scratch.mPlanMisses );
+	if( plans.size() == sMaxDecodePlans )
+		return nullptr;
+	plans.push_back( compileDecodePlan( types, numTypes ) );
+	scratch.mNumPlans.store( plans.size(), std::memory_order_relaxed );
+	scratch.mLastPlan = plans.size() - 1;
+	return &plans.back();
+}
+
+ReceiverBase::DecodePlan ReceiverBase::compileDecodePlan( const char *types, size_t numTypes )
+{
+	DecodePlan plan;
+	plan.mTypes.assign( types, numTypes );
+	uint32_t offset = 0;
+	for( size_t i = 0; i < numTypes; i++ ) {
+		uint32_t size = 0;
+		switch( types[i] ) {
+			case 'i':
+			case 'f':
+			case 'r':
+			case 'c':
+			case 'm': size = 4; break;
+			case 'h':
+			case 'd':
+			case 't': size = 8; break;
+			case 's':
+			case 'S':
+			case 'b': plan.mIsFixed = false; break;
+			default: break;
+		}
+		if( ! plan.mIsFixed ) {
+			// offsets depend on the contents, these are decoded argument by argument.
+			plan.mArgs.clear();
+			plan.mSwapRuns.clear();
+			return plan;
+		}
+		
+		auto type = Argument::translateCharToArgType( types[i] );
+		auto swapSize = getEndianSwapSize( type );
+		plan.mArgs.push_back( { type, size ? int32_t( offset ) : -1, size, swapSize != 0 } );
+		if( swapSize ) {
+			if( ! plan.mSwapRuns.empty() && plan.mSwapRuns.back().mSize == swapSize
+			   && plan.mSwapRuns.back().mOffset + plan.mSwapRuns.back().mCount * swapSize == offset )
+				plan.mSwapRuns.back().mCount++;
+			else
+				plan.mSwapRuns.push_back( { offset, 1, swapSize } );
+		}
+		offset += size;
+	}
+	plan.mArgsSize = offset;
+	return plan;
+}
+
+double ReceiverBase::getDecodePlanHitRate() const
+{
+	auto hits = mDecodeScratch.mPlanHits.load( std::memory_order_relaxed );
+	auto total = hits + mDecodeScratch.mPlanMisses.load( std::memory_order_relaxed );
+	return total ? double( hits ) / total : 0.0;
+}
+
 bool ReceiverBase::patternMatch( const std::string& lhs, const std::string& rhs ) const
+{
+	return patternMatch( lhs.c_str(), lhs.size(), rhs.c_str(), rhs.size() );
+}
+
+bool ReceiverBase::patternMatch( const char *lhs, size_t length, const std::string& rhs ) const
+{
+	return patternMatch( lhs, length, rhs.c_str(), rhs.size() );
+}
+
+bool ReceiverBase::patternMatch( const char *lhs, size_t lhsLength, const char *rhs, size_t rhsLength ) const
 {
 	bool negate = false;
 	bool mismatched = false;
-	std::string::const_iterator seq_tmp;
-	std::string::const_iterator seq = lhs.begin();
-	std::string::const_iterator seq_end = lhs.end();
-	std::string::const_iterator pattern = rhs.begin();
-	std::string::const_iterator pattern_end = rhs.end();
+	const char *seq_tmp;
+	const char *seq = lhs;
+	const char *seq_end = lhs + lhsLength;
+	const char *pattern = rhs;
+	const char *pattern_end = rhs + rhsLength;
+	// patterns may come from incoming messages, so every step is checked against the ends.
 	while( seq != seq_end && pattern != pattern_end ) {
 		switch( *pattern ) {
 			case '?':
@@ -1051,61 +3106,55 @@ bool ReceiverBase::patternMatch( const std::string& lhs, const std::string& rhs
 			case '*': {
 				// if * is the last pattern, return true
 				if( ++pattern == pattern_end ) return true;
-				while( *seq != *pattern && seq != seq_end ) ++seq;
+				while( seq != seq_end && *seq != *pattern ) ++seq;
 				// if seq reaches to the end without matching pattern
 				if( seq == seq_end ) return false;
 			}
 				break;
 			case '[': {
 				negate = false;
-				mismatched = false;
-				if( *( ++pattern ) == '!' ) {
+				if( ++pattern == pattern_end ) return false;
+				if( *pattern == '!' ) {
 					negate = true;
-					++pattern;
+					if( ++pattern == pattern_end ) return false;
 				}
-				if( *( pattern + 1 ) == '-' ) {
+				if( pattern_end - pattern > 2 && *( pattern + 1 ) == '-' ) {
 					// range matching
 					char c_start = *pattern; ++pattern;
-					//assert(*pattern == '-');
 					char c_end = *( ++pattern ); ++pattern;
-					//assert(*pattern == ']');
 					// swap c_start and c_end if c_start is larger
-					if( c_start > c_end ) {
-						char tmp = c_start;
-						c_end = c_start;
-						c_start = tmp;
-					}
+					if( c_start > c_end )
+						std::swap( c_start, c_end );
 					mismatched = ( c_start <= *seq && *seq <= c_end ) ? negate : !negate;
 					if( mismatched ) return false;
 				}
 				else {
 					// literal matching
-					while( *pattern != ']' ) {
-						if( *seq == *pattern ) {
-							mismatched = negate;
-							break;
-						}
+					bool found = false;
+					while( pattern != pattern_end && *pattern != ']' ) {
+						if( *seq == *pattern )
+							found = true;
 						++pattern;
 					}
-					if( mismatched ) return false;
-					while( *pattern != ']' ) ++pattern;
+					if( found == negate ) return false;
 				}
+				if( pattern == pattern_end || *pattern != ']' ) return false;
 			}
 				break;
 			case '{': {
 				seq_tmp = seq;
 				mismatched = true;
-				while( *( ++pattern ) != '}' ) {
+				while( ++pattern != pattern_end && *pattern != '}' ) {
 					// this assumes that there's no sequence like "{,a}" where ',' is
 					// follows immediately after '{', which is illegal.
 					if( *pattern == ',' ) {
 						mismatched = false;
 						break;
 					}
-					else if( *seq != *pattern ) {
+					else if( seq == seq_end || *seq != *pattern ) {
 						// fast forward to the next ',' or '}'
-						while( *( ++pattern ) != ',' && *pattern != '}' );
-						if( *pattern == '}' ) return false;
+						while( ++pattern != pattern_end && *pattern != ',' && *pattern != '}' );
+						if( pattern == pattern_end || *pattern == '}' ) return false;
 						// redo seq matching
 						seq = seq_tmp;
 						mismatched = true;
@@ -1117,7 +3166,8 @@ bool ReceiverBase::patternMatch( const std::string& lhs, const std::string& rhs
 					}
 				}
 				if( mismatched ) return false;
-				while( *pattern != '}' ) ++pattern;
+				while( pattern != pattern_end && *pattern != '}' ) ++pattern;
+				if( pattern == pattern_end ) return false;
 				--seq;
 			}
 				break;
@@ -1127,25 +3177,26 @@ bool ReceiverBase::patternMatch( const std::string& lhs, const std::string& rhs
 		}
 		++seq; ++pattern;
 	}
-	if( seq == seq_end && pattern == pattern_end ) return true;
-	else return false;
+	// a trailing * matches nothing as well.
+	while( seq == seq_end && pattern != pattern_end && *pattern == '*' ) ++pattern;
+	return seq == seq_end && pattern == pattern_end;
 }
-	
+
 /////////////////////////////////////////////////////////////////////////////////////////
 //// ReceiverUdp
 	
 ReceiverUdp::ReceiverUdp( uint16_t port, const asio::ip::udp &protocol, asio::io_service &service )
-: mSocket( new udp::socket( service ) ), mLocalEndpoint( protocol, port ), mAmountToReceive( 4096 )
+: mSocket( new udp::socket( service ) ), mLocalEndpoint( protocol, port ), mAmountToReceive( 4096 ), mReceiveBuffers( 4 )
 {
 }
 
 ReceiverUdp::ReceiverUdp( const asio::ip::udp::endpoint &localEndpoint, asio::io_service &io )
-: mSocket( new udp::socket( io ) ), mLocalEndpoint( localEndpoint ), mAmountToReceive( 4096 )
+: mSocket( new udp::socket( io ) ), mLocalEndpoint( localEndpoint ), mAmountToReceive( 4096 ), mReceiveBuffers( 4 )
 {
 }
 
 ReceiverUdp::ReceiverUdp( UdpSocketRef socket )
-: mSocket( socket ), mLocalEndpoint( socket->local_endpoint() ), mAmountToReceive( 4096 )
+: mSocket( socket ), mLocalEndpoint( socket->local_endpoint() ), mAmountToReceive( 4096 ), mReceiveBuffers( 4 )
 {
 }
 	
@@ -1155,32 +3206,235 @@ void ReceiverUdp::bindImpl()
 	mSocket->bind( mLocalEndpoint );
 }
 
+#if defined( __linux__ )
+struct ReceiverUdp::BatchState {
+	std::vector<mmsghdr>	mMessages;
+	std::vector<iovec>		mIovecs;
+	std::vector<uint8_t>	mControl;
+};
+#else
+struct ReceiverUdp::BatchState {};
+#endif
+
+void ReceiverUdp::setBatchReceive( size_t batchSize, bool useGro )
+{
+#if defined( __linux__ )
+	mBatchSize = batchSize;
+	mUseGro = useGro;
+	mReceiveStorage.reset();
+#else
+	if( batchSize )
+		CI_LOG_W( "Batch receive is only supported on Linux, receiving one datagram at a time." );
+#endif
+}
+
+void ReceiverUdp::allocateReceiveBuffers()
+{
+	// every datagram of a batch needs its own buffer, however many were asked for.
+	if( mReceiveBuffers.size() < mBatchSize )
+		mReceiveBuffers.resize( mBatchSize );
+	
+	// one extra byte to null terminate the datagram, rounded up to whole cache lines.
+	const size_t alignment = 64;
+	size_t stride = ( mAmountToReceive + 1 + alignment - 1 ) & ~( alignment - 1 );
+	mReceiveStorage.reset( new uint8_t[ stride * mReceiveBuffers.size() + alignment ] );
+	auto aligned = reinterpret_cast<uintptr_t>( mReceiveStorage.get() );
+	aligned = ( aligned + alignment - 1 ) & ~uintptr_t( alignment - 1 );
+	for( auto & receiveBuffer : mReceiveBuffers ) {
+		receiveBuffer.mData = reinterpret_cast<uint8_t*>( aligned );
+		receiveBuffer.mInUse = false;
+		aligned += stride;
+	}
+	mNextReceiveBuffer = 0;
+	
+#if defined( __linux__ )
+	mBatchState.reset();
+	if( ! mBatchSize )
+		return;
+	
+	auto state = std::make_shared<BatchState>();
+	const size_t controlSize = CMSG_SPACE( sizeof( int ) );
+	state->mMessages.resize( mBatchSize );
+	state->mIovecs.resize( mBatchSize );
+	state->mControl.resize( mBatchSize * controlSize );
+	memset( state->mMessages.data(), 0, mBatchSize * sizeof( mmsghdr ) );
+	for( size_t i = 0; i < mBatchSize; i++ ) {
+		auto &header = state->mMessages[i].msg_hdr;
+		state->mIovecs[i].iov_base = mReceiveBuffers[i].mData;
+		state->mIovecs[i].iov_len = mAmountToReceive;
+		header.msg_iov = &state->mIovecs[i];
+		header.msg_iovlen = 1;
+		header.msg_name = mReceiveBuffers[i].mEndpoint.data();
+		header.msg_control = &state->mControl[i * controlSize];
+	}
+	if( mUseGro ) {
+		int enable = 1;
+		if( setsockopt( mSocket->native_handle(), SOL_UDP, UDP_GRO, &enable, sizeof( enable ) ) != 0 ) {
+			CI_LOG_W( "UDP_GRO isn't supported, receiving batches without it." );
+			mUseGro = false;
+		}
+	}
+	mBatchState = state;
+#endif
+}
+
 void ReceiverUdp::listenImpl()
 {
-	auto tempBuffer = mBuffer.prepare( mAmountToReceive );
-	auto uniqueEndpoint = std::make_shared<asio::ip::udp::endpoint>();
-	mSocket->async_receive_from( tempBuffer, *uniqueEndpoint,
-	[&, uniqueEndpoint]( const asio::error_code &error, size_t bytesTransferred ) {
+	if( mBatchSize ) {
+		listenBatch();
+		return;
+	}
+	
+	size_t index;
+	{
+		std::lock_guard<std::mutex> lock( mReceiveMutex );
+		// The socket was closed, don't arm a receive that can only fail.
+		if( ! mSocket->is_open() )
+			return;
+		if( ! mReceiveStorage )
+			allocateReceiveBuffers();
+		// A receive is already pending, or all buffers are still being dispatched, in which case
+		// the next one is armed once a buffer is released.
+		if( mIsReceiving || mReceiveBuffers[mNextReceiveBuffer].mInUse )
+			return;
+		index = mNextReceiveBuffer;
+		mNextReceiveBuffer = ( mNextReceiveBuffer + 1 ) % mReceiveBuffers.size();
+		mReceiveBuffers[index].mInUse = true;
+		mIsReceiving = true;
+	}
+	
+	auto &receiveBuffer = mReceiveBuffers[index];
+	mSocket->async_receive_from( asio::buffer( receiveBuffer.mData, mAmountToReceive ), receiveBuffer.mEndpoint,
+	[&, index]( const asio::error_code &error, size_t bytesTransferred ) {
+		onReceive( index, error, bytesTransferred );
+	});
+}
+
+void ReceiverUdp::onReceive( size_t index, const asio::error_code &error, size_t bytesTransferred )
+{
+	auto &receiveBuffer = mReceiveBuffers[index];
+	{
+		std::lock_guard<std::mutex> lock( mReceiveMutex );
+		mIsReceiving = false;
+	}
+	
+	if( error ) {
+		std::lock_guard<std::mutex> lock( mSocketTransportErrorFnMutex );
+		if( mSocketTransportErrorFn ) {
+			mSocketTransportErrorFn( error, receiveBuffer.mEndpoint );
+		}
+		else {
+			CI_LOG_E( error.message() << ", didn't receive message from " << receiveBuffer.mEndpoint.address().to_string() );
+		}
+	}
+	else {
+		// keep receiving into the next buffer while this one is dispatched in place.
+		listen();
+		receiveBuffer.mData[ bytesTransferred ] = 0;
+		std::lock_guard<std::mutex> lock( mDispatchMutex );
+		dispatchMethods( receiveBuffer.mData, bytesTransferred );
+	}
+	
+	{
+		std::lock_guard<std::mutex> lock( mReceiveMutex );
+		receiveBuffer.mInUse = false;
+	}
+	listen();
+}
+	
+void ReceiverUdp::listenBatch()
+{
+	{
+		std::lock_guard<std::mutex> lock( mReceiveMutex );
+		if( ! mSocket->is_open() )
+			return;
+		if( ! mReceiveStorage )
+			allocateReceiveBuffers();
+		if( mIsReceiving )
+			return;
+		mIsReceiving = true;
+	}
+	
+	// only wait for the socket to be readable, the datagrams are read at once by receiveBatch.
+	mSocket->async_receive( asio::null_buffers(),
+	[&]( const asio::error_code &error, size_t /*bytesTransferred*/ ) {
+		{
+			std::lock_guard<std::mutex> lock( mReceiveMutex );
+			mIsReceiving = false;
+		}
 		if( error ) {
 			std::lock_guard<std::mutex> lock( mSocketTransportErrorFnMutex );
 			if( mSocketTransportErrorFn ) {
-				mSocketTransportErrorFn( error, *uniqueEndpoint );
+				mSocketTransportErrorFn( error, asio::ip::udp::endpoint() );
 			}
 			else {
-				CI_LOG_E( error.message() << ", didn't receive message from " << uniqueEndpoint->address().to_string() );
+				CI_LOG_E( error.message() << ", didn't receive messages" );
 			}
 		}
-		else {
-			mBuffer.commit( bytesTransferred );
-			auto data = std::unique_ptr<uint8_t[]>( new uint8_t[ bytesTransferred + 1 ] );
-			data[ bytesTransferred ] = 0;
-			istream stream( &mBuffer );
-			stream.read( reinterpret_cast<char*>( data.get() ), bytesTransferred );
-			dispatchMethods( data.get(), bytesTransferred );
-		}
+		else
+			receiveBatch();
 		listen();
 	});
 }
+
+void ReceiverUdp::receiveBatch()
+{
+#if defined( __linux__ )
+	auto &messages = mBatchState->mMessages;
+	const size_t controlSize = mUseGro ? CMSG_SPACE( sizeof( int ) ) : 0;
+	// the kernel overwrites the lengths of the previous batch.
+	for( size_t i = 0; i < messages.size(); i++ ) {
+		messages[i].msg_hdr.msg_namelen = mReceiveBuffers[i].mEndpoint.capacity();
+		messages[i].msg_hdr.msg_controllen = controlSize;
+	}
+	
+	int received = recvmmsg( mSocket->native_handle(), messages.data(), (unsigned int) messages.size(), MSG_DONTWAIT, nullptr );
+	if( received < 0 ) {
+		if( errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR )
+			return;
+		asio::error_code error( errno, asio::error::get_system_category() );
+		std::lock_guard<std::mutex> lock( mSocketTransportErrorFnMutex );
+		if( mSocketTransportErrorFn ) {
+			mSocketTransportErrorFn( error, asio::ip::udp::endpoint() );
+		}
+		else {
+			CI_LOG_E( error.message() << ", didn't receive messages" );
+		}
+		return;
+	}
+	
+	std::lock_guard<std::mutex> lock( mDispatchMutex );
+	for( int i = 0; i < received; i++ ) {
+		auto &receiveBuffer = mReceiveBuffers[i];
+		auto &header = messages[i].msg_hdr;
+		receiveBuffer.mEndpoint.resize( header.msg_namelen );
+		
+		size_t size = messages[i].msg_len;
+		size_t segmentSize = size;
+		if( mUseGro ) {
+			for( auto cmsg = CMSG_FIRSTHDR( &header ); cmsg; cmsg = CMSG_NXTHDR( &header, cmsg ) ) {
+				if( cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO ) {
+					int gsoSize;
+					memcpy( &gsoSize, CMSG_DATA( cmsg ), sizeof( int ) );
+					if( gsoSize > 0 )
+						segmentSize = gsoSize;
+				}
+			}
+		}
+		
+		// coalesced datagrams lie back to back, all but the last one are segmentSize bytes.
+		for( size_t offset = 0; offset < size; offset += segmentSize ) {
+			auto data = receiveBuffer.mData + offset;
+			auto length = std::min( segmentSize, size - offset );
+			// null terminate the datagram, without losing the first byte of the next one.
+			auto next = data[length];
+			data[length] = 0;
+			dispatchMethods( data, (uint32_t) length );
+			data[length] = next;
+		}
+	}
+#endif
+}
 	
 void ReceiverUdp::setSocketErrorFn( SocketTransportErrorFn<protocol> errorFn )
 {
@@ -1188,6 +3442,140 @@ void ReceiverUdp::setSocketErrorFn( SocketTransportErrorFn<protocol> errorFn )
 	mSocketTransportErrorFn = errorFn;
 }
 	
+/////////////////////////////////////////////////////////////////////////////////////////
+//// ReceiverUdpSharded
+
+ReceiverUdpSharded::Shard::Shard( ReceiverUdpSharded *owner, const protocol::endpoint &localEndpoint, asio::io_service &io )
+: ReceiverUdp( localEndpoint, io ), mOwner( owner )
+{
+}
+
+void ReceiverUdpSharded::Shard::bindImpl()
+{
+	mSocket->open( mLocalEndpoint.protocol() );
+#if defined( SO_REUSEPORT )
+	int enable = 1;
+	if( setsockopt( mSocket->native_handle(), SOL_SOCKET, SO_REUSEPORT, &enable, sizeof( enable ) ) != 0 )
+		throw asio::system_error( asio::error_code( errno, asio::error::get_system_category() ), "SO_REUSEPORT" );
+#endif
+	mSocket->bind( mLocalEndpoint );
+}
+
+ReceiverUdpSharded::ReceiverUdpSharded( uint16_t port, size_t numShards, const protocol &protocol )
+{
+	createShards( protocol::endpoint( protocol, port ), numShards );
+}
+
+ReceiverUdpSharded::ReceiverUdpSharded( const protocol::endpoint &localEndpoint, size_t numShards )
+{
+	createShards( localEndpoint, numShards );
+}
+
+ReceiverUdpSharded::~ReceiverUdpSharded()
+{
+	closeImpl();
+}
+
+void ReceiverUdpSharded::createShards( const protocol::endpoint &localEndpoint, size_t numShards )
+{
+#if defined( SO_REUSEPORT )
+	if( numShards == 0 )
+		numShards = std::max<size_t>( std::thread::hardware_concurrency(), 1 );
+#else
+	if( numShards > 1 )
+		CI_LOG_W( "SO_REUSEPORT isn't supported, receiving on a single socket." );
+	numShards = 1;
+#endif
+	for( size_t i = 0; i < numShards; i++ ) {
+		mServices.emplace_back( new asio::io_service );
+		mShards.emplace_back( new Shard( this, localEndpoint, *mServices.back() ) );
+	}
+}
+
+size_t ReceiverUdpSharded::getDecodePlanCacheSize() const
+{
+	size_t size = 0;
+	for( auto & shard : mShards )
+		size += shard->mDecodeScratch.mNumPlans.load( std::memory_order_relaxed );
+	return size;
+}
+
+double ReceiverUdpSharded::getDecodePlanHitRate() const
+{
+	size_t hits = 0, total = 0;
+	for( auto & shard : mShards ) {
+		auto shardHits = shard->mDecodeScratch.mPlanHits.load( std::memory_order_relaxed );
+		hits += shardHits;
+		total += shardHits + shard->mDecodeScratch.mPlanMisses.load( std::memory_order_relaxed );
+	}
+	return total ? double( hits ) / total : 0.0;
+}
+
+void ReceiverUdpSharded::setPolling( size_t /*capacity*/ )
+{
+	CI_LOG_E( "ReceiverUdpSharded doesn't support polling, its sockets dispatch from a thread each. Use inline or POOL listeners instead." );
+}
+
+void ReceiverUdpSharded::setAmountToReceive( uint32_t amountToReceive )
+{
+	for( auto & shard : mShards )
+		shard->setAmountToReceive( amountToReceive );
+}
+
+void ReceiverUdpSharded::setBatchReceive( size_t batchSize, bool useGro )
+{
+	for( auto & shard : mShards )
+		shard->setBatchReceive( batchSize, useGro );
+}
+
+void ReceiverUdpSharded::setSocketErrorFn( SocketTransportErrorFn<protocol> errorFn )
+{
+	for( auto & shard : mShards )
+		shard->setSocketErrorFn( errorFn );
+}
+
+void ReceiverUdpSharded::bindImpl()
+{
+	for( auto & shard : mShards )
+		shard->bind();
+}
+
+void ReceiverUdpSharded::listenImpl()
+{
+	if( ! mThreads.empty() )
+		return;
+	
+	for( size_t i = 0; i < mShards.size(); i++ ) {
+		auto service = mServices[i].get();
+		service->reset();
+		mShards[i]->listen();
+		mThreads.emplace_back( [service] { service->run(); } );
+	}
+}
+
+void ReceiverUdpSharded::closeImpl()
+{
+	// close each socket on its own thread. The aborted receive's handler releases its buffer
+	// without arming another receive, after which the thread runs out of work and returns.
+	for( size_t i = 0; i < mShards.size() && ! mThreads.empty(); i++ ) {
+		auto shard = mShards[i].get();
+		mServices[i]->post( [shard] { shard->close(); } );
+	}
+	for( auto & thread : mThreads )
+		thread.join();
+	mThreads.clear();
+	
+	for( auto & shard : mShards ) {
+		shard->close();
+		// a service that had already stopped never ran its receive's handler, so release the
+		// ring here for the next listen().
+		std::lock_guard<std::mutex> lock( shard->mReceiveMutex );
+		shard->mIsReceiving = false;
+		for( auto & receiveBuffer : shard->mReceiveBuffers )
+			receiveBuffer.mInUse = false;
+	}
+}
+	
 /////////////////////////////////////////////////////////////////////////////////////////
 //// ReceiverTcp
 
@@ -1250,10 +3638,7 @@ void ReceiverTcp::Connection::read()
 			data[ bytesTransferred ] = 0;
 			istream stream( &mBuffer );
 			stream.read( reinterpret_cast<char*>( data.get() ), bytesTransferred );
-			{
-				std::lock_guard<std::mutex> lock( mReceiver->mDispatchMutex );
-				mReceiver->dispatchMethods( (data.get() + 4), bytesTransferred );
-			}
+			mReceiver->dispatchMethods( (data.get() + 4), bytesTransferred, mDecodeScratch );
 		}
 		read();
 	});
@@ -1315,6 +3700,27 @@ void ReceiverTcp::accept()
 	}, socket, _1 ) );
 }
 
+size_t ReceiverTcp::getDecodePlanCacheSize() const
+{
+	std::lock_guard<std::mutex> lock( mConnectionMutex );
+	size_t size = 0;
+	for( auto & connection : mConnections )
+		size += connection->mDecodeScratch.mNumPlans.load( std::memory_order_relaxed );
+	return size;
+}
+
+double ReceiverTcp::getDecodePlanHitRate() const
+{
+	std::lock_guard<std::mutex> lock( mConnectionMutex );
+	size_t hits = 0, total = 0;
+	for( auto & connection : mConnections ) {
+		auto connectionHits = connection->mDecodeScratch.mPlanHits.load( std::memory_order_relaxed );
+		hits += connectionHits;
+		total += connectionHits + connection->mDecodeScratch.mPlanMisses.load( std::memory_order_relaxed );
+	}
+	return total ? double( hits ) / total : 0.0;
+}
+
 void ReceiverTcp::closeImpl()
 {
 	mAcceptor->close();
@@ -1341,6 +3747,8 @@ const char* argTypeToString( ArgType type )
 		case ArgType::CHAR: return "CHAR"; break;
 		case ArgType::NULL_T: return "NULL_T"; break;
 		case ArgType::INFINITUM: return "INFINITUM"; break;
+		case ArgType::ARRAY_BEGIN: return "ARRAY_BEGIN"; break;
+		case ArgType::ARRAY_END: return "ARRAY_END"; break;
 		case ArgType::NONE: return "NONE"; break;
 		default: return "Unknown ArgType"; break;
 	}
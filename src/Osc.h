@@ -34,7 +34,14 @@
 #endif
 #include "asio/asio.hpp"
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <limits>
 #include <mutex>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
 
 #include "cinder/Buffer.h"
 #include "cinder/app/App.h"
@@ -48,7 +55,7 @@
 namespace osc {
 	
 //! Argument types suported by the Message class
-enum class ArgType { INTEGER_32, FLOAT, DOUBLE, STRING, BLOB, MIDI, TIME_TAG, INTEGER_64, BOOL_T, BOOL_F, CHAR, NULL_T, INFINITUM, NONE };
+enum class ArgType { INTEGER_32, FLOAT, DOUBLE, STRING, BLOB, MIDI, TIME_TAG, INTEGER_64, BOOL_T, BOOL_F, CHAR, NULL_T, INFINITUM, ARRAY_BEGIN, ARRAY_END, NONE };
 	
 // Forward declarations
 class Message;
@@ -56,10 +63,277 @@ using UdpSocketRef = std::shared_ptr<asio::ip::udp::socket>;
 using TcpSocketRef = std::shared_ptr<asio::ip::tcp::socket>;
 using AcceptorRef = std::shared_ptr<asio::ip::tcp::acceptor>;
 	
+//! Abstract source of memory, modelled after std::pmr::memory_resource. Messages, bundles and
+//! receivers can be given one to keep their allocations off the global heap.
+class MemoryResource {
+public:
+	virtual ~MemoryResource() = default;
+	//! Allocates \a bytes aligned to \a alignment.
+	virtual void* allocate( size_t bytes, size_t alignment ) = 0;
+	//! Releases \a ptr, which was allocated with the same \a bytes and \a alignment.
+	virtual void deallocate( void *ptr, size_t bytes, size_t alignment ) = 0;
+};
+
+//! MemoryResource that hands out memory from large blocks and releases everything at once with
+//! reset(). Blocks are kept for reuse, so a reset arena serves the same load without allocating.
+class MonotonicArena : public MemoryResource {
+public:
+	explicit MonotonicArena( size_t blockSize = 64 * 1024 );
+	~MonotonicArena();
+	MonotonicArena( const MonotonicArena & ) = delete;
+	MonotonicArena& operator=( const MonotonicArena & ) = delete;
+	
+	void* allocate( size_t bytes, size_t alignment ) override;
+	//! Does nothing, memory is only released by reset().
+	void deallocate( void * /*ptr*/, size_t /*bytes*/, size_t /*alignment*/ ) override {}
+	//! Releases every allocation made from this arena in one shot.
+	void reset();
+	
+private:
+	std::vector<std::pair<uint8_t*, size_t>>	mBlocks;
+	size_t										mBlockSize, mCurrentBlock, mOffset;
+};
+
+//! Standard library allocator that draws from a MemoryResource, or from the global heap when the
+//! resource is null.
+template<typename T>
+class ResourceAllocator {
+public:
+	using value_type = T;
+	
+	ResourceAllocator( MemoryResource *resource = nullptr ) NOEXCEPT : mResource( resource ) {}
+	template<typename U>
+	ResourceAllocator( const ResourceAllocator<U> &other ) NOEXCEPT : mResource( other.getResource() ) {}
+	
+	T* allocate( size_t n )
+	{
+		if( mResource )
+			return static_cast<T*>( mResource->allocate( n * sizeof( T ), std::alignment_of<T>::value ) );
+		return static_cast<T*>( ::operator new( n * sizeof( T ) ) );
+	}
+	void deallocate( T *ptr, size_t n )
+	{
+		if( mResource )
+			mResource->deallocate( ptr, n * sizeof( T ), std::alignment_of<T>::value );
+		else
+			::operator delete( ptr );
+	}
+	
+	MemoryResource* getResource() const { return mResource; }
+	
+private:
+	MemoryResource* mResource;
+};
+template<typename T, typename U>
+bool operator==( const ResourceAllocator<T> &lhs, const ResourceAllocator<U> &rhs ) { return lhs.getResource() == rhs.getResource(); }
+template<typename T, typename U>
+bool operator!=( const ResourceAllocator<T> &lhs, const ResourceAllocator<U> &rhs ) { return lhs.getResource() != rhs.getResource(); }
+	
 template<size_t size>
 using ByteArray = std::array<uint8_t, size>;
 using ByteBuffer = std::vector<uint8_t>;
 using ByteBufferRef = std::shared_ptr<ByteBuffer>;
+//! Byte buffer whose storage is drawn from a MemoryResource. Kept apart from ByteBuffer, which
+//! stays a plain std::vector so existing code that names it keeps compiling.
+using ResourceByteBuffer = std::vector<uint8_t, ResourceAllocator<uint8_t>>;
+using ByteBufferList = std::vector<ByteBufferRef, ResourceAllocator<ByteBufferRef>>;
+	
+//! Vector-like container that stores up to \a N elements inline and only spills to the heap, or
+//! to its MemoryResource if it has one, when it grows beyond that. Used by Message to avoid
+//! allocating for typical messages.
+template<typename T, size_t N>
+class SmallVector {
+public:
+	explicit SmallVector( MemoryResource *resource = nullptr )
+	: mData( inlineData() ), mSize( 0 ), mCapacity( N ), mResource( resource ) {}
+	SmallVector( SmallVector &&other ) NOEXCEPT
+	: mData( inlineData() ), mSize( 0 ), mCapacity( N ), mResource( other.mResource ) { moveFrom( other ); }
+	SmallVector& operator=( SmallVector &&other ) NOEXCEPT
+	{
+		if( this != &other ) {
+			clear();
+			deallocate();
+			mResource = other.mResource;
+			moveFrom( other );
+		}
+		return *this;
+	}
+	SmallVector( const SmallVector & ) = delete;
+	SmallVector& operator=( const SmallVector & ) = delete;
+	~SmallVector() { clear(); deallocate(); }
+	
+	size_t		size() const { return mSize; }
+	size_t		capacity() const { return mCapacity; }
+	bool		empty() const { return mSize == 0; }
+	//! Returns true if the elements are stored inline rather than on the heap.
+	bool		isInline() const { return mData == inlineData(); }
+	//! Returns the resource that storage beyond the inline capacity is allocated from.
+	MemoryResource* getResource() const { return mResource; }
+	
+	T*			data() { return mData; }
+	const T*	data() const { return mData; }
+	T*			begin() { return mData; }
+	const T*	begin() const { return mData; }
+	T*			end() { return mData + mSize; }
+	const T*	end() const { return mData + mSize; }
+	T&			back() { return mData[mSize - 1]; }
+	const T&	back() const { return mData[mSize - 1]; }
+	T&			operator[]( size_t index ) { return mData[index]; }
+	const T&	operator[]( size_t index ) const { return mData[index]; }
+	
+	//! Makes sure there's room for \a capacity elements, spilling to the heap if needed.
+	void reserve( size_t capacity )
+	{
+		if( capacity <= mCapacity )
+			return;
+		auto data = ResourceAllocator<T>( mResource ).allocate( capacity );
+		for( size_t i = 0; i < mSize; i++ ) {
+			new( data + i ) T( std::move( mData[i] ) );
+			mData[i].~T();
+		}
+		deallocate();
+		mData = data;
+		mCapacity = capacity;
+	}
+	
+	template<typename... Args>
+	void emplace_back( Args&&... args )
+	{
+		grow( mSize + 1 );
+		new( mData + mSize ) T( std::forward<Args>( args )... );
+		mSize++;
+	}
+	void push_back( T &&v ) { emplace_back( std::move( v ) ); }
+	void push_back( const T &v ) { emplace_back( v ); }
+	
+	//! Copies the elements from \a first to \a last to the back of the container.
+	void append( const T *first, const T *last )
+	{
+		grow( mSize + ( last - first ) );
+		for( ; first != last; ++first )
+			new( mData + mSize++ ) T( *first );
+	}
+	
+	void resize( size_t size )
+	{
+		grow( size );
+		while( mSize < size )
+			new( mData + mSize++ ) T();
+		while( mSize > size )
+			mData[--mSize].~T();
+	}
+	void resize( size_t size, const T &value )
+	{
+		grow( size );
+		while( mSize < size )
+			new( mData + mSize++ ) T( value );
+		while( mSize > size )
+			mData[--mSize].~T();
+	}
+	
+	//! Destroys all elements, keeping the current capacity.
+	void clear()
+	{
+		while( mSize > 0 )
+			mData[--mSize].~T();
+	}
+	
+private:
+	T*			inlineData() { return reinterpret_cast<T*>( mInline ); }
+	const T*	inlineData() const { return reinterpret_cast<const T*>( mInline ); }
+	
+	void grow( size_t size )
+	{
+		if( size > mCapacity )
+			reserve( std::max( size, mCapacity * 2 ) );
+	}
+	void deallocate()
+	{
+		if( ! isInline() )
+			ResourceAllocator<T>( mResource ).deallocate( mData, mCapacity );
+		mData = inlineData();
+		mCapacity = N;
+	}
+	//! Expects this to be empty and inline.
+	void moveFrom( SmallVector &other )
+	{
+		if( other.isInline() ) {
+			for( size_t i = 0; i < other.mSize; i++ )
+				new( mData + i ) T( std::move( other.mData[i] ) );
+			mSize = other.mSize;
+			other.clear();
+		}
+		else {
+			mData = other.mData;
+			mSize = other.mSize;
+			mCapacity = other.mCapacity;
+			other.mData = other.inlineData();
+			other.mSize = 0;
+			other.mCapacity = N;
+		}
+	}
+	
+	typename std::aligned_storage<sizeof( T ), std::alignment_of<T>::value>::type mInline[N];
+	T*				mData;
+	size_t			mSize, mCapacity;
+	MemoryResource*	mResource;
+};
+	
+//! Returns the 64 bit FNV-1a hash of the \a length chars of \a address. Usable at compile time.
+constexpr uint64_t hashAddress( const char *address, size_t length, uint64_t hash = 14695981039346656037ULL )
+{
+	return length ? hashAddress( address + 1, length - 1, ( hash ^ uint8_t( *address ) ) * 1099511628211ULL ) : hash;
+}
+	
+//! An OSC address literal with its hash worked out at compile time, made with the _osc literal.
+struct AddressLiteral {
+	const char	*mAddress;
+	size_t		mLength;
+	uint64_t	mHash;
+};
+	
+//! Stands for an interned OSC address, a small integer that's the same for equal addresses and
+//! stable for the lifetime of the process. Comparing ids doesn't touch the address strings.
+class AddressId {
+public:
+	//! Creates the invalid id, which stands for no address.
+	AddressId() = default;
+	//! Returns the id of \a address, interning it if it's new. Interned addresses are never freed.
+	explicit AddressId( const std::string &address );
+	//! Returns the id of the \a literal, interning it with its precomputed hash if it's new.
+	AddressId( const AddressLiteral &literal );
+	
+	//! Returns the integer value of the id, 0 for the invalid id.
+	uint32_t getValue() const { return mValue; }
+	//! Returns whether this id stands for an address.
+	bool isValid() const { return mValue != 0; }
+	//! Returns the interned address, which is empty for the invalid id.
+	const std::string& getAddress() const;
+	
+	bool operator==( const AddressId &other ) const { return mValue == other.mValue; }
+	bool operator!=( const AddressId &other ) const { return mValue != other.mValue; }
+	bool operator<( const AddressId &other ) const { return mValue < other.mValue; }
+	
+	//! Returns the id of \a address of \a length chars, whose hashAddress is \a hash, interning it
+	//! if it's new.
+	static AddressId intern( const char *address, size_t length, uint64_t hash );
+	
+private:
+	explicit AddressId( uint32_t value ) : mValue( value ) {}
+	
+	uint32_t mValue = 0;
+};
+	
+namespace literals {
+	
+//! Hashes the OSC address literal \a address at compile time, i.e. "/mixer/1/fader"_osc, which
+//! converts to an AddressId.
+constexpr AddressLiteral operator"" _osc( const char *address, size_t length )
+{
+	return AddressLiteral{ address, length, hashAddress( address, length ) };
+}
+	
+} // namespace literals
 	
 /// This class represents an Open Sound Control message. It supports Open Sound
 /// Control 1.0 and 1.1 specifications and extra non-standard arguments listed
@@ -70,6 +344,11 @@ public:
 	//! Create an OSC message.
 	Message() = default;
 	explicit Message( const std::string& address );
+	//! Create an OSC message with the interned \a address.
+	explicit Message( const AddressId &address );
+	//! Create an OSC message, whose argument storage beyond the inline capacity and the control
+	//! block of its cache are allocated from \a resource. \a resource has to outlive the message.
+	Message( MemoryResource *resource, const std::string& address );
 	Message( const Message & ) = delete;
 	Message& operator=( const Message & ) = delete;
 	Message( Message && ) NOEXCEPT;
@@ -90,6 +369,10 @@ public:
 	void append( float v );
 	//! Appends a string to the back of the message.
 	void append( const std::string& v );
+	//! Appends the null terminated string \a v to the back of the message.
+	void append( const char *v );
+	//! Appends the first \a size characters of \a v as a string to the back of the message.
+	void append( const char *v, size_t size );
 	//! Appends an osc blob to the back of the message.
 	void appendBlob( void* blob, uint32_t size );
 	//! Appends an osc blob to the back of the message.
@@ -118,8 +401,15 @@ public:
 	void append( char v );
 	//! Appends a midi value to the back of the message.
 	void appendMidi( uint8_t port, uint8_t status, uint8_t data1, uint8_t data2 );
-	// TODO: figure out if array is useful.
-	// void appendArray( void* array, size_t size );
+	
+	// Functions for appending runs of numeric arguments in one go
+	
+	//! Appends \a count floats to the back of the message. If \a asArray is true, they're enclosed
+	//! in an OSC 1.1 array, '[' and ']', which take up an argument index each.
+	void appendFloats( const float *values, size_t count, bool asArray = false );
+	//! Appends \a count int32s to the back of the message. If \a asArray is true, they're enclosed
+	//! in an OSC 1.1 array, '[' and ']', which take up an argument index each.
+	void appendInts( const int32_t *values, size_t count, bool asArray = false );
     
     // Variadic template append function to add multiple args of arbitrary type
     template <typename T, typename... Args>
@@ -171,19 +461,75 @@ public:
 	//! throws ExcNonConvertible
 	void getArgBlobData( uint32_t index, const void **dataPtr, size_t *size ) const;
 	
+	//! Copies up to \a count consecutive floats, starting at \a index, into \a values and returns the
+	//! amount copied. If \a index is the start of an array, copies from its first element up to its
+	//! end. If index is out of bounds, throws ExcIndexOutOfBounds. If the first argument isn't
+	//! convertible to this type, throws ExcNonConvertible
+	size_t		getFloats( uint32_t index, float *values, size_t count ) const;
+	//! Copies up to \a count consecutive int32s, starting at \a index, into \a values and returns the
+	//! amount copied. If \a index is the start of an array, copies from its first element up to its
+	//! end. If index is out of bounds, throws ExcIndexOutOfBounds. If the first argument isn't
+	//! convertible to this type, throws ExcNonConvertible
+	size_t		getInts( uint32_t index, int32_t *values, size_t count ) const;
+	
 	//! Returns the argument type located at \a index.
 	ArgType		getArgType( uint32_t index ) const;
 	
+	// Functions for replacing fixed size arguments in place. If the message is already cached,
+	// the cache is patched directly instead of being rebuilt.
+	
+	//! Replaces the int32_t located at \a index with \a v. If index is out of bounds, throws
+	//! ExcIndexOutOfBounds. If argument isn't of this type, throws ExcNonConvertible
+	void		setArg( uint32_t index, int32_t v );
+	//! Replaces the float located at \a index with \a v. If index is out of bounds, throws
+	//! ExcIndexOutOfBounds. If argument isn't of this type, throws ExcNonConvertible
+	void		setArg( uint32_t index, float v );
+	//! Replaces the int64_t located at \a index with \a v. If index is out of bounds, throws
+	//! ExcIndexOutOfBounds. If argument isn't of this type, throws ExcNonConvertible
+	void		setArg( uint32_t index, int64_t v );
+	//! Replaces the double located at \a index with \a v. If index is out of bounds, throws
+	//! ExcIndexOutOfBounds. If argument isn't of this type, throws ExcNonConvertible
+	void		setArg( uint32_t index, double v );
+	//! Replaces the char located at \a index with \a v. If index is out of bounds, throws
+	//! ExcIndexOutOfBounds. If argument isn't of this type, throws ExcNonConvertible
+	void		setArg( uint32_t index, char v );
+	//! Replaces the bool located at \a index with \a v. If index is out of bounds, throws
+	//! ExcIndexOutOfBounds. If argument isn't of this type, throws ExcNonConvertible
+	void		setArg( uint32_t index, bool v );
+	//! Replaces the time_tag located at \a index with \a v. If index is out of bounds, throws
+	//! ExcIndexOutOfBounds. If argument isn't of this type, throws ExcNonConvertible
+	void		setArgTime( uint32_t index, uint64_t v );
+	//! Replaces the midi value located at \a index. If index is out of bounds, throws
+	//! ExcIndexOutOfBounds. If argument isn't of this type, throws ExcNonConvertible
+	void		setArgMidi( uint32_t index, uint8_t port, uint8_t status, uint8_t data1, uint8_t data2 );
+	
 	//! Sets the OSC address of this message.
 	void setAddress( const std::string& address );
+	//! Sets the OSC address of this message to the interned \a address.
+	void setAddress( const AddressId &address );
 	//! Returns the OSC address of this message.
 	const std::string& getAddress() const { return mAddress; }
-	
-	//! Returns the size of this OSC message as a complete packet.
-	//! Performs a lazy cache
-	size_t size() const;
+	//! Returns the interned OSC address of this message, interning it on first use. Messages
+	//! decoded for a listener registered with their exact address carry it already.
+	AddressId getAddressId() const;
+	//! Returns the MemoryResource this message allocates from, or nullptr for the global heap.
+	MemoryResource* getMemoryResource() const { return mResource; }
+	
+	//! Returns the size of this OSC message as a complete packet, including the 4 byte
+	//! size prefix. Calculated arithmetically, doesn't build the cache.
+	size_t size() const { return 4 + encodedSize(); }
+	//! Returns the size of the encoded OSC message (address, type tag and arguments), without
+	//! the 4 byte size prefix. Calculated arithmetically, doesn't build the cache.
+	size_t encodedSize() const;
+	//! Encodes this message in a single pass into \a buffer, which is \a size bytes long.
+	//! Writes the address, type tag and big-endian arguments, without the 4 byte size prefix.
+	//! Returns the amount of bytes written, or 0 if \a buffer is too small to hold encodedSize().
+	size_t encodeInto( uint8_t *buffer, size_t size ) const;
 	/// Clears the message, specifically any cache, dataViews, and address.
 	void clear();
+	//! Reserves room for \a dataSize bytes of argument data and \a numArgs arguments, so appending
+	//! up to that amount doesn't allocate. Typical messages fit in the inline storage anyway.
+	void reserve( size_t dataSize, size_t numArgs );
 	
 	class Argument {
 	public:
@@ -243,8 +589,6 @@ public:
 		void		outputValueToStream( std::ostream &ostream ) const;
 		//! Returns true, if before transporting this message, this argument needs a big endian swap
 		bool		needsEndianSwapForTransmit() const { return mNeedsEndianSwapForTransmit; }
-		//! Implements the swap for all types needing a swap.
-		void		swapEndianForTransmit( uint8_t* buffer ) const;
 		//! Helper to check if the underlying type is able to be converted to the provided template
 		//! type \a T.
 		template<typename T>
@@ -261,6 +605,8 @@ public:
 		bool			mNeedsEndianSwapForTransmit;
 		
 		friend class Message;
+		friend class MessageView;
+		friend class ReceiverBase;
 		friend std::ostream& operator<<( std::ostream &os, const Message &rhs );
 	};
 	//! Subscript operator returns a const Argument& based on \a index. If index is out of
@@ -283,68 +629,407 @@ private:
 	//! Helper to to insert data starting at \a begin for \a with resize/fill in the amount
 	//! of \a trailingZeros
 	void appendDataBuffer( const void *begin, uint32_t size, uint32_t trailingZeros = 0 );
+	//! Helper to overwrite the argument at \a index, which has to be of \a type, with \a size
+	//! bytes of host ordered \a data and, if cached, with the big endian \a wireData.
+	void setArgData( uint32_t index, ArgType type, const void *data, const void *wireData, uint32_t size );
+	//! Returns the cache ready to be patched in place, or nullptr if the message isn't cached.
+	uint8_t* getMutableCache();
+	//! Helper to append \a count arguments of \a type, each \a size bytes, from \a values at once,
+	//! optionally enclosed in an array.
+	void appendArgRun( ArgType type, const void *values, uint32_t size, size_t count, bool asArray );
+	//! Helper to copy up to \a count consecutive arguments of \a type, each \a size bytes, starting
+	//! at \a index into \a values.
+	size_t getArgRun( uint32_t index, ArgType type, void *values, uint32_t size, size_t count ) const;
 	
 	//! Returns a complete byte array of this OSC message as a ByteBufferRef type.
 	//! The byte buffer is constructed lazily and is cached until the cache is
 	//! obsolete. Call to |data| and |size| perform the same caching.
 	ByteBufferRef getSharedBuffer() const;
 	
-	std::string				mAddress;
-	ByteBuffer				mDataBuffer;
-	std::vector<Argument>	mDataViews;
-	mutable bool			mIsCached;
+	std::string						mAddress;
+	//! The interned mAddress, invalid until it's been asked for or known.
+	mutable AddressId				mAddressId;
+	// Typical messages fit in the inline storage, larger ones spill to the heap.
+	SmallVector<uint8_t, 256>		mDataBuffer;
+	SmallVector<Argument, 16>		mDataViews;
+	mutable bool			mIsCached = false;
 	mutable ByteBufferRef	mCache;
+	MemoryResource*			mResource = nullptr;
 	
 	//! Create the OSC message and store it in cache.
 	void createCache() const;
 	//! Used by receiver to create the inner message.
-	bool bufferCache( uint8_t *data, size_t size );
+	bool bufferCache( const uint8_t *data, size_t size );
 	
 	friend class Bundle;
+	friend class MessageTemplate;
 	friend class SenderBase;
 	friend class SenderUdp;
+	friend class MessageView;
 	friend class ReceiverBase;
+	friend class StateTable;
 	friend std::ostream& operator<<( std::ostream &os, const Message &rhs );
 };
 
 //! Convenient stream operator for Message
 std::ostream& operator<<( std::ostream &os, const Message &rhs );
+
+//! Represents a non-owning, read only view of an encoded OSC message, as it was received. The
+//! address and type tag are parsed on first use and arguments are decoded from the big endian wire
+//! data when they're accessed, so nothing is copied. The viewed bytes have to outlive the view.
+class MessageView {
+public:
+	//! Creates a view of the encoded message of \a size bytes at \a data, without the size prefix.
+	MessageView( const uint8_t *data, size_t size );
+	
+	//! Returns true if the address and type tag of the viewed message are well formed.
+	bool		isValid() const;
+	//! Returns the OSC address of the viewed message, pointing into the viewed bytes. Returns an
+	//! empty string if the message isn't valid.
+	const char*	getAddress() const;
+	//! Returns the length of the OSC address of the viewed message.
+	size_t		getAddressLength() const;
+	//! Returns the amount of arguments of the viewed message.
+	size_t		getNumArgs() const;
+	//! Returns the argument type located at \a index. If index is out of bounds, throws ExcIndexOutOfBounds.
+	ArgType		getArgType( uint32_t index ) const;
+	//! Returns the viewed bytes of the message.
+	const uint8_t*	data() const { return mData; }
+	//! Returns the size of the viewed bytes.
+	size_t		size() const { return mSize; }
+	
+	//! Returns the int32_t located at \a index. If index is out of bounds, throws ExcIndexOutOfBounds.
+	//! If argument isn't convertible to this type, throws ExcNonConvertible
+	int32_t		getArgInt( uint32_t index ) const;
+	//! Returns the float located at \a index. If index is out of bounds, throws ExcIndexOutOfBounds.
+	//! If argument isn't convertible to this type, throws ExcNonConvertible
+	float		getArgFloat( uint32_t index ) const;
+	//! Returns the string located at \a index, pointing into the viewed bytes. If index is out of
+	//! bounds, throws ExcIndexOutOfBounds. If argument isn't convertible to this type, throws ExcNonConvertible
+	const char*	getArgString( uint32_t index ) const;
+	//! Returns the time_tag located at \a index. If index is out of bounds, throws ExcIndexOutOfBounds.
+	//! If argument isn't convertible to this type, throws ExcNonConvertible
+	int64_t		getArgTime( uint32_t index ) const;
+	//! Returns the int64_t located at \a index. If index is out of bounds, throws ExcIndexOutOfBounds.
+	//! If argument isn't convertible to this type, throws ExcNonConvertible
+	int64_t		getArgInt64( uint32_t index ) const;
+	//! Returns the double located at \a index. If index is out of bounds, throws ExcIndexOutOfBounds.
+	//! If argument isn't convertible to this type, throws ExcNonConvertible
+	double		getArgDouble( uint32_t index ) const;
+	//! Returns the bool located at \a index. If index is out of bounds, throws ExcIndexOutOfBounds.
+	//! If argument isn't convertible to this type, throws ExcNonConvertible
+	bool		getArgBool( uint32_t index ) const;
+	//! Returns the char located at \a index. If index is out of bounds, throws ExcIndexOutOfBounds.
+	//! If argument isn't convertible to this type, throws ExcNonConvertible
+	char		getArgChar( uint32_t index ) const;
+	//! Supplies values for the four arguments in the midi format located at \a index. If index is out
+	//! of bounds, throws ExcIndexOutOfBounds. If argument isn't convertible to this type, throws
+	//! ExcNonConvertible
+	void		getArgMidi( uint32_t index, uint8_t *port, uint8_t *status, uint8_t *data1, uint8_t *data2 ) const;
+	//! Supplies the blob data located at \a index to the \a dataPtr and \a size. Note: Doesn't copy.
+	//! If index is out of bounds, throws ExcIndexOutOfBounds. If argument isn't convertible to this type,
+	//! throws ExcNonConvertible
+	void		getArgBlobData( uint32_t index, const void **dataPtr, size_t *size ) const;
+	
+private:
+	//! Parses the address and type tag, once.
+	void parseHeader() const;
+	//! Returns the wire data of the argument at \a index, checking that it's convertible to \a type
+	//! and that it's within the viewed bytes.
+	const uint8_t* getArgData( uint32_t index, ArgType type ) const;
+	//! Returns the offset of the argument at \a index, walking from the last accessed argument.
+	size_t getArgOffset( uint32_t index ) const;
+	//! Returns the size on the wire of the argument at \a index located at \a offset.
+	size_t getArgSize( uint32_t index, size_t offset ) const;
+	
+	const uint8_t*			mData;
+	size_t					mSize;
+	mutable bool			mIsParsed = false;
+	mutable bool			mIsValid = false;
+	mutable size_t			mAddressLength = 0;
+	mutable const char*		mTypes = nullptr;
+	mutable size_t			mNumArgs = 0;
+	mutable size_t			mArgsOffset = 0;
+	// Arguments are usually read in order, remembering the last one makes that linear overall.
+	mutable uint32_t		mCursorIndex = 0;
+	mutable size_t			mCursorOffset = 0;
+	
+	friend class ReceiverBase;
+};
+
+//! Represents a pre-encoded OSC message, whose address and type tag are fixed. The wire buffer is
+//! built once from a prototype Message and the fixed size arguments are then patched in place,
+//! which makes repeatedly sending the same shape of message cheap.
+class MessageTemplate {
+public:
+	//! Creates a template from \a prototype, whose address, types and current argument values
+	//! make up the initial wire buffer. String and blob arguments are encoded as is and can't be set.
+	explicit MessageTemplate( const Message &prototype );
+	MessageTemplate( const MessageTemplate & ) = delete;
+	MessageTemplate& operator=( const MessageTemplate & ) = delete;
+	
+	//! Sets the int32 at \a index. If index is out of bounds, throws ExcIndexOutOfBounds.
+	//! If the slot isn't of this type, throws ExcNonConvertible
+	void set( uint32_t index, int32_t v );
+	//! Sets the float at \a index. If index is out of bounds, throws ExcIndexOutOfBounds.
+	//! If the slot isn't of this type, throws ExcNonConvertible
+	void set( uint32_t index, float v );
+	//! Sets the int64 at \a index. If index is out of bounds, throws ExcIndexOutOfBounds.
+	//! If the slot isn't of this type, throws ExcNonConvertible
+	void set( uint32_t index, int64_t v );
+	//! Sets the double at \a index. If index is out of bounds, throws ExcIndexOutOfBounds.
+	//! If the slot isn't of this type, throws ExcNonConvertible
+	void set( uint32_t index, double v );
+	//! Sets the char at \a index. If index is out of bounds, throws ExcIndexOutOfBounds.
+	//! If the slot isn't of this type, throws ExcNonConvertible
+	void set( uint32_t index, char v );
+	//! Sets the boolean at \a index, by switching its type between 'T' and 'F'. If index is out
+	//! of bounds, throws ExcIndexOutOfBounds. If the slot isn't of this type, throws ExcNonConvertible
+	void set( uint32_t index, bool v );
+	//! Sets the time_tag at \a index. If index is out of bounds, throws ExcIndexOutOfBounds.
+	//! If the slot isn't of this type, throws ExcNonConvertible
+	void setTimeTag( uint32_t index, uint64_t v );
+	//! Sets the midi value at \a index. If index is out of bounds, throws ExcIndexOutOfBounds.
+	//! If the slot isn't of this type, throws ExcNonConvertible
+	void setMidi( uint32_t index, uint8_t port, uint8_t status, uint8_t data1, uint8_t data2 );
+	
+	//! Returns the OSC address of this template.
+	const std::string& getAddress() const { return mAddress; }
+	//! Returns the argument type located at \a index.
+	ArgType getArgType( uint32_t index ) const;
+	//! Returns the amount of arguments in this template.
+	size_t getNumArgs() const { return mSlots.size(); }
+	//! Returns the size of this OSC message as a complete packet, including the 4 byte size prefix.
+	size_t size() const { return mCache->size(); }
+	
+private:
+	struct Slot {
+		ArgType		mType;
+		//! Offset into the wire buffer of the argument, or of its type tag char for booleans.
+		uint32_t	mOffset;
+	};
+	
+	//! Returns the slot at \a index, checking that it's of type \a type.
+	const Slot& getSlot( uint32_t index, ArgType type ) const;
+	//! Writes \a size bytes from \a data at \a offset into the wire buffer.
+	void write( uint32_t offset, const void *data, size_t size );
+	//! Returns the wire buffer, ready to be sent.
+	const ByteBufferRef& getSharedBuffer() const { return mCache; }
+	
+	std::string			mAddress;
+	std::vector<Slot>	mSlots;
+	ByteBufferRef		mCache;
+	
+	friend class Bundle;
+	friend class SenderBase;
+};
+	
+//! Writes \a v to \a ptr in big endian (network) byte order.
+inline void writeBigEndian( uint8_t *ptr, uint32_t v )
+{
+	ptr[0] = uint8_t( v >> 24 ); ptr[1] = uint8_t( v >> 16 ); ptr[2] = uint8_t( v >> 8 ); ptr[3] = uint8_t( v );
+}
+//! Writes \a v to \a ptr in big endian (network) byte order.
+inline void writeBigEndian( uint8_t *ptr, uint64_t v )
+{
+	writeBigEndian( ptr, uint32_t( v >> 32 ) );
+	writeBigEndian( ptr + 4, uint32_t( v ) );
+}
+
+//! Describes how an argument of type \a T is encoded by TypedMessage. Specialized for int32_t,
+//! float, int64_t, double, char and bool.
+template<typename T>
+struct ArgTraits;
+
+template<>
+struct ArgTraits<int32_t> {
+	static constexpr size_t size = 4;
+	static void encode( uint8_t *tag, uint8_t *data, int32_t v ) { *tag = 'i'; writeBigEndian( data, uint32_t( v ) ); }
+};
+template<>
+struct ArgTraits<float> {
+	static constexpr size_t size = 4;
+	static void encode( uint8_t *tag, uint8_t *data, float v )
+	{
+		uint32_t a;
+		memcpy( &a, &v, sizeof( float ) );
+		*tag = 'f';
+		writeBigEndian( data, a );
+	}
+};
+template<>
+struct ArgTraits<int64_t> {
+	static constexpr size_t size = 8;
+	static void encode( uint8_t *tag, uint8_t *data, int64_t v ) { *tag = 'h'; writeBigEndian( data, uint64_t( v ) ); }
+};
+template<>
+struct ArgTraits<double> {
+	static constexpr size_t size = 8;
+	static void encode( uint8_t *tag, uint8_t *data, double v )
+	{
+		uint64_t a;
+		memcpy( &a, &v, sizeof( double ) );
+		*tag = 'd';
+		writeBigEndian( data, a );
+	}
+};
+template<>
+struct ArgTraits<char> {
+	static constexpr size_t size = 4;
+	static void encode( uint8_t *tag, uint8_t *data, char v ) { *tag = 'c'; writeBigEndian( data, uint32_t( uint8_t( v ) ) ); }
+};
+template<>
+struct ArgTraits<bool> {
+	static constexpr size_t size = 0;
+	static void encode( uint8_t *tag, uint8_t */*data*/, bool v ) { *tag = v ? 'T' : 'F'; }
+};
+
+//! Sums the encoded sizes of the argument types \a Args.
+template<typename... Args>
+struct ArgsSize;
+template<>
+struct ArgsSize<> {
+	static constexpr size_t value = 0;
+};
+template<typename T, typename... Args>
+struct ArgsSize<T, Args...> {
+	static constexpr size_t value = ArgTraits<T>::size + ArgsSize<Args...>::value;
+};
+
+//! Declares a type named \a name that carries the OSC address literal \a address for TypedMessage.
+#define OSC_ADDRESS( name, address )												\
+	struct name {																	\
+		static const char* value() { return address; }								\
+		static constexpr size_t length = sizeof( address ) - 1;						\
+	}
+
+//! Represents an OSC message whose address and argument types are known at compile time, i.e.
+//! TypedMessage<MixChannel, int32_t, float, float> with MixChannel declared through OSC_ADDRESS.
+//! The padded address, type tag and packet sizes are constants and arguments are encoded with
+//! inlined byte swaps, without going through Message's argument bookkeeping.
+template<typename Address, typename... Args>
+class TypedMessage {
+public:
+	//! Size of the address, including its null padding.
+	static constexpr size_t addressSize = Address::length + 4 - Address::length % 4;
+	//! Size of the type tag, including the ',' separator and null padding.
+	static constexpr size_t typesSize = sizeof...( Args ) + 1 + 4 - ( sizeof...( Args ) + 1 ) % 4;
+	//! Size of the encoded arguments.
+	static constexpr size_t argumentsSize = ArgsSize<Args...>::value;
+	//! Size of the complete packet, including the 4 byte size prefix.
+	static constexpr size_t packetSize = 4 + addressSize + typesSize + argumentsSize;
+	
+	using Packet = ByteArray<packetSize>;
+	
+	//! Encodes a complete packet, including the 4 byte size prefix, with \a args into \a packet.
+	static void encode( Packet &packet, Args... args )
+	{
+		packet.fill( 0 );
+		encodeHeader( packet.data() );
+		encodeArgs( packet.data() + 4 + addressSize + 1, packet.data() + 4 + addressSize + typesSize, args... );
+	}
+	
+	//! Creates the message with \a args.
+	explicit TypedMessage( Args... args )
+	: mCache( new ByteBuffer( packetSize ) )
+	{
+		encodeHeader( mCache->data() );
+		set( args... );
+	}
+	TypedMessage( const TypedMessage & ) = delete;
+	TypedMessage& operator=( const TypedMessage & ) = delete;
+	
+	//! Replaces all the arguments with \a args.
+	void set( Args... args )
+	{
+		// Don't patch a buffer that a sender may still be transmitting asynchronously.
+		if( mCache.use_count() > 1 )
+			mCache = ByteBufferRef( new ByteBuffer( *mCache ) );
+		encodeArgs( mCache->data() + 4 + addressSize + 1, mCache->data() + 4 + addressSize + typesSize, args... );
+	}
+	
+	//! Returns the OSC address of this message.
+	static const char* getAddress() { return Address::value(); }
+	//! Returns the size of this OSC message as a complete packet, including the 4 byte size prefix.
+	static constexpr size_t size() { return packetSize; }
+	
+private:
+	//! Writes the size prefix, address and ',' separator. Expects the padding to be zeroed.
+	static void encodeHeader( uint8_t *packet )
+	{
+		writeBigEndian( packet, uint32_t( packetSize - 4 ) );
+		memcpy( packet + 4, Address::value(), Address::length );
+		packet[4 + addressSize] = ',';
+	}
+	static void encodeArgs( uint8_t */*tag*/, uint8_t */*data*/ ) {}
+	template<typename T, typename... Rest>
+	static void encodeArgs( uint8_t *tag, uint8_t *data, T v, Rest... rest )
+	{
+		ArgTraits<T>::encode( tag, data, v );
+		encodeArgs( tag + 1, data + ArgTraits<T>::size, rest... );
+	}
+	
+	const ByteBufferRef& getSharedBuffer() const { return mCache; }
+	
+	ByteBufferRef mCache;
+	
+	friend class Bundle;
+	friend class SenderBase;
+};
 	
 //! Represents an Open Sound Control bundle message. A bundle can contains any number
-//! of Messages and Bundles.
+//! of Messages and Bundles. Rather than copying its elements, a bundle references their
+//! cached buffers, which senders transmit with gather I/O.
 class Bundle {
 public:
 	
 	//! Creates a OSC bundle with timestamp set to immediate. Call set_timetag to
-	//! set a custom timestamp.
-	Bundle();
+	//! set a custom timestamp. The bundle's header and buffer list are allocated from
+	//! \a resource, if provided, which has to outlive the bundle.
+	explicit Bundle( MemoryResource *resource = nullptr );
 	~Bundle() = default;
 	
-	//! Appends an OSC message to this bundle. The message's byte buffer is immediately
-	//! copied into this bundle and any changes to the message after the call to this
-	//! function does not affect this bundle.
+	//! Appends an OSC message to this bundle. The bundle references the message's cached
+	//! byte buffer, which the message replaces rather than modifies once it changes, so any
+	//! changes to the message after the call to this function does not affect this bundle.
 	void append( const Message &message ) { appendData( message.getSharedBuffer() ); }
-	//! Appends an OSC bundle to this bundle. The bundle's contents are immediately copied
-	//! into this bundle and any changes to the message after the call to this
-	//! function does not affect this bundle.
-	void append( const Bundle &bundle ) { appendData( bundle.getSharedBuffer() ); }
+	//! Appends an OSC bundle to this bundle. The bundle's header is copied and its elements are
+	//! referenced, so any changes to the bundle after the call to this function does not
+	//! affect this bundle.
+	void append( const Bundle &bundle );
+	//! Appends the current state of an OSC message template to this bundle. Later changes to the
+	//! template don't affect this bundle.
+	void append( const MessageTemplate &messageTemplate ) { appendData( messageTemplate.getSharedBuffer() ); }
+	//! Appends the current state of a typed message to this bundle. Later changes to the message
+	//! don't affect this bundle.
+	template<typename Address, typename... Args>
+	void append( const TypedMessage<Address, Args...> &message ) { appendData( message.getSharedBuffer() ); }
 	
 	/// Sets timestamp of the bundle.
 	void setTimetag( uint64_t ntp_time );
 	
-	//! Returns the size of this OSC bundle.
-	size_t size() const { return mDataBuffer->size(); }
+	//! Returns the size of this OSC bundle, including the 4 byte size prefix.
+	size_t size() const { return mSize; }
 	
-	//! Clears the bundle.
-	void clear() { mDataBuffer->clear(); }
+	//! Clears the bundle's elements, keeping its timestamp.
+	void clear();
 	
 private:
-	ByteBufferRef mDataBuffer;
+	//! The 4 byte size prefix, "#bundle" and the timetag.
+	static const size_t sHeaderSize = 20;
 	
-	/// Returns a pointer to the byte array of this OSC bundle. This call is
-	/// convenient for actually sending this OSC bundle.
-	ByteBufferRef getSharedBuffer() const;
+	ByteBufferList	mBuffers;
+	size_t			mSize;
+	MemoryResource*	mResource;
 	
+	/// Returns the bundle's header followed by its elements' buffers, each starting with its
+	/// size. Their concatenation is the complete packet, ready to be sent with gather I/O.
+	const ByteBufferList& getSharedBuffers() const { return mBuffers; }
+	
+	//! Returns the header, copying it first if a sender may still be transmitting it.
+	uint8_t* getMutableHeader();
+	//! Writes the current size into the header's size prefix.
+	void updateHeaderSize();
 	void appendData( const ByteBufferRef& data );
 	
 	friend class SenderBase;
@@ -366,8 +1051,18 @@ public:
 	void bind() { bindImpl(); }
 	//! Sends \a message to the destination endpoint.
 	void send( const Message &message ) { sendImpl( message.getSharedBuffer() ); }
-	//! Sends \a bundle to the destination endpoint.
-	void send( const Bundle &bundle ) { sendImpl( bundle.getSharedBuffer() ); }
+	//! Sends \a bundle to the destination endpoint, gathering the buffers of its elements.
+	void send( const Bundle &bundle ) { sendImpl( bundle.getSharedBuffers() ); }
+	//! Sends the current state of \a messageTemplate to the destination endpoint.
+	void send( const MessageTemplate &messageTemplate ) { sendImpl( messageTemplate.getSharedBuffer() ); }
+	//! Sends the current state of the typed \a message to the destination endpoint.
+	template<typename Address, typename... Args>
+	void send( const TypedMessage<Address, Args...> &message ) { sendImpl( message.getSharedBuffer() ); }
+	//! Sends each of the \a count \a messages as its own packet to the destination endpoint, which
+	//! the network layer may submit at once. Errors are reported for each message.
+	void send( const Message *messages, size_t count );
+	//! Sends each of \a messages as its own packet to the destination endpoint, see above.
+	void send( const std::vector<Message> &messages ) { send( messages.data(), messages.size() ); }
 	//! Closes the underlying connection to the socket.
 	void close() { closeImpl(); }
 	
@@ -384,6 +1079,14 @@ protected:
 	
 	//! Abstract send function implemented by the network layer.
 	virtual void sendImpl( const ByteBufferRef &byteBuffer ) = 0;
+	//! Sends the concatenation of \a byteBuffers as one packet. The default implementation
+	//! copies them into a single buffer for sendImpl(), network layers supporting gather I/O
+	//! override it.
+	virtual void sendImpl( const ByteBufferList &byteBuffers );
+	//! Sends each of \a byteBuffers as its own packet. The default implementation calls sendImpl()
+	//! for each of them, network layers supporting batched sends override it. Called with
+	//! mBatchMutex held.
+	virtual void sendBatchImpl( const ByteBufferList &byteBuffers );
 	//! Abstract close function implemented by the network layer
 	virtual void closeImpl() = 0;
 	//! Abstract bind function implemented by the network layer
@@ -391,6 +1094,11 @@ protected:
 	
 	SocketTransportErrorFn	mSocketTransportErrorFn;
 	std::mutex				mSocketErrorFnMutex;
+	//! Reused to collect the buffers of a batch, emptied after each send.
+	ByteBufferList			mBatchBuffers;
+	//! Serializes batches, so concurrent callers don't share mBatchBuffers or the network
+	//! layer's batch state.
+	std::mutex				mBatchMutex;
 };
 	
 //! Represents an OSC Sender (called a \a server in the OSC spec) and implements the UDP
@@ -431,11 +1139,43 @@ protected:
 	void bindImpl() override;
 	//! Sends the byte buffer /a data to the remote endpoint using the UDP socket, asynchronously.
 	void sendImpl( const ByteBufferRef &data ) override;
+	//! Sends the concatenation of /a data as one datagram to the remote endpoint using the UDP
+	//! socket, asynchronously and without copying them when possible.
+	void sendImpl( const ByteBufferList &data ) override;
+	//! Sends each of /a data as its own datagram. On Linux, runs of equally sized datagrams are
+	//! sent with a single segmented (UDP_SEGMENT) send and the others with sendmmsg. Once the
+	//! socket is full, the remaining datagrams, and those of later batches, are queued in order
+	//! and sent when it's writable again.
+	void sendBatchImpl( const ByteBufferList &data ) override;
 	//! Closes the underlying UDP socket.
 	void closeImpl() override;
+	//! Sends the datagrams of \a data until the socket is full and returns how many were handled.
+	size_t sendBatch( const ByteBufferList &data );
+	//! Waits for the socket to be writable and sends the queued datagrams. Expects mBatchMutex
+	//! to be held.
+	void sendPendingBatch();
+	//! Sends the run of equally sized datagrams starting at \a first with one segmented send and
+	//! returns how many were handled, or 0 if there's no such run or the socket is full.
+	size_t sendSegmented( const ByteBufferList &data, size_t first );
+	//! Sends up to a batch of datagrams starting at \a first with one sendmmsg call and returns
+	//! how many were handled, or 0 if the socket is full.
+	size_t sendMultiple( const ByteBufferList &data, size_t first );
+	//! Sends the concatenation of /a data as one datagram with a single sendmsg call, waiting for
+	//! the socket asynchronously if it can't take it right away. Used for bundles with more
+	//! elements than asio passes to one send.
+	void sendGathered( const ByteBufferList &data );
+	//! Reports \a error for sending \a data.
+	void handleSendError( const asio::error_code &error, const ByteBufferRef &data );
+	
+	//! Holds the platform's batch send structures.
+	struct BatchState;
 	
 	UdpSocketRef			mSocket;
 	protocol::endpoint		mLocalEndpoint, mRemoteEndpoint;
+	std::shared_ptr<BatchState>	mBatchState;
+	//! Datagrams of batches waiting for the socket to be writable, in the order they were sent.
+	ByteBufferList			mPendingBatch;
+	bool					mUseSegmentation = true;
 	
 public:
 	//! Non-copyable.
@@ -488,6 +1228,9 @@ protected:
 	void bindImpl() override;
 	//! Sends the byte buffer /a data to the remote endpoint using the TCP socket, asynchronously.
 	void sendImpl( const ByteBufferRef &data ) override;
+	//! Sends the concatenation of /a data to the remote endpoint using the TCP socket,
+	//! asynchronously and without copying them.
+	void sendImpl( const ByteBufferList &data ) override;
 	//! Closes the underlying TCP socket.
 	void closeImpl() override { mSocket->close(); }
 	
@@ -505,6 +1248,111 @@ public:
 	SenderTcp& operator=( SenderTcp &&other ) = delete;
 };
 
+//! A pool of worker threads, each running the tasks posted to it in order. Tasks are posted
+//! with a key, i.e. the hash of an address, and the same key always lands on the same worker.
+//! So tasks of one address run in order, while different addresses run in parallel.
+class DispatchPool {
+public:
+	//! Starts \a numThreads workers, at least one.
+	explicit DispatchPool( size_t numThreads = std::thread::hardware_concurrency() );
+	//! Runs the tasks that are still queued and joins the workers.
+	~DispatchPool();
+	
+	//! Queues \a task on the worker of \a key.
+	void	post( uint64_t key, std::function<void()> task );
+	//! Returns the amount of workers.
+	size_t	getNumThreads() const { return mWorkers.size(); }
+	
+private:
+	struct Worker {
+		std::mutex							mMutex;
+		std::condition_variable				mCondition;
+		std::deque<std::function<void()>>	mTasks;
+		bool								mIsStopping = false;
+		std::thread							mThread;
+	};
+	
+	void run( Worker &worker );
+	
+	std::vector<std::unique_ptr<Worker>>	mWorkers;
+	
+public:
+	//! Non-copyable.
+	DispatchPool( const DispatchPool &other ) = delete;
+	//! Non-copyable.
+	DispatchPool& operator=( const DispatchPool &other ) = delete;
+};
+	
+using DispatchPoolRef = std::shared_ptr<DispatchPool>;
+	
+//! Keeps the latest message of each of a fixed set of addresses, for continuous controls where
+//! only the most recent value matters. Every address has a preallocated slot that receivers
+//! write under a seqlock, whose sequence also serializes the writers of the slot, so any amount
+//! of threads can read a slot without locking and never see a half written message. Every write stamps its slot with the table's frame, a count of
+//! the writes so far. To see every change, take getFrame() before reading the slots and ask
+//! what's changed since that frame the next time around.
+class StateTable {
+public:
+	//! Creates a slot for each of \a addresses, which keeps messages of up to \a maxMessageSize
+	//! bytes. Larger messages aren't kept.
+	explicit StateTable( const std::vector<std::string> &addresses, size_t maxMessageSize = 256 );
+	
+	//! Returns the slot of \a address, or npos if it has none.
+	size_t		getSlot( const std::string &address ) const;
+	//! Returns the amount of slots.
+	size_t		getNumSlots() const { return mNumSlots; }
+	//! Returns the address of \a slot.
+	const std::string&	getAddress( size_t slot ) const { return mSlots[slot].mAddress; }
+	//! Returns the current frame. Remember it to later ask what's changed since.
+	uint64_t	getFrame() const { return mFrame.load( std::memory_order_acquire ); }
+	
+	//! Decodes the latest message of \a slot into \a message and returns true, or false if
+	//! nothing has been written to it yet. \a frame, if given, is set to the frame of the write.
+	//! Slots of more than 512 bytes are copied through a buffer kept per thread.
+	bool		read( size_t slot, Message &message, uint64_t *frame = nullptr ) const;
+	//! Like read() above, copying the slot through \a words, which is grown to fit once and can be
+	//! reused from read to read.
+	bool		read( size_t slot, Message &message, std::vector<uint64_t> &words, uint64_t *frame = nullptr ) const;
+	//! Returns whether \a slot has been written to after \a frame.
+	bool		hasChangedSince( size_t slot, uint64_t frame ) const;
+	//! Sets \a slots to the slots that have been written to after \a frame.
+	void		getChangedSince( uint64_t frame, std::vector<size_t> &slots ) const;
+	
+	//! Writes the \a size bytes of the message at \a data to \a slot and returns true, or false
+	//! if it doesn't fit. Called by receivers.
+	bool		write( size_t slot, const uint8_t *data, size_t size );
+	
+	static const size_t npos = std::numeric_limits<size_t>::max();
+	
+private:
+	struct Slot {
+		std::string				mAddress;
+		//! Odd while a write is in progress, bumped twice by every write. Writers take the slot by
+		//! making it odd.
+		std::atomic<uint32_t>	mSequence;
+		std::atomic<uint64_t>	mFrame;
+		std::atomic<uint32_t>	mSize;
+		//! The message, in words so that readers copy it with atomic loads.
+		std::unique_ptr<std::atomic<uint64_t>[]>	mWords;
+	};
+	
+	std::unique_ptr<Slot[]>					mSlots;
+	size_t									mNumSlots, mNumWords;
+	std::unordered_map<std::string, size_t>	mSlotIndices;
+	std::atomic<uint64_t>					mFrame;
+	
+	//! Copies the latest message of \a slot to \a words, which fit mNumWords, and decodes it.
+	bool		readWords( size_t slot, Message &message, uint64_t *words, uint64_t *frame ) const;
+	
+public:
+	//! Non-copyable.
+	StateTable( const StateTable &other ) = delete;
+	//! Non-copyable.
+	StateTable& operator=( const StateTable &other ) = delete;
+};
+	
+using StateTableRef = std::shared_ptr<StateTable>;
+
 //! Represents an OSC Receiver(called a \a client in the OSC spec) and implements a unified
 //! interface without implementing any of the networking layer.
 class ReceiverBase {
@@ -518,6 +1366,15 @@ public:
 	using ListenerFn = std::function<void( const Message &message )>;
 	//! Alias container for callbacks.
 	using Listeners = std::vector<std::pair<std::string, ListenerFn>>;
+	//! Alias function representing a zero-copy message callback.
+	using ViewListenerFn = std::function<void( const MessageView &message )>;
+	//! Alias container for zero-copy callbacks.
+	using ViewListeners = std::vector<std::pair<std::string, ViewListenerFn>>;
+	//! Alias function that runs \a task, i.e. by queueing it on another thread.
+	using Executor = std::function<void( std::function<void()> task )>;
+	//! Where a Message listener runs. INLINE runs it on the receiving thread, POOL on the worker
+	//! of its address in the receiver's DispatchPool and EXECUTOR through its own Executor.
+	enum class Execution { INLINE, POOL, EXECUTOR };
 	
 	//! Binds the underlying network socket. Should be called before trying communication operations.
 	void		bind() { bindImpl(); }
@@ -530,6 +1387,58 @@ public:
 	void		setListener( const std::string &address, ListenerFn listener );
 	//! Removes the listener associated with \a address.
 	void		removeListener( const std::string &address );
+	//! Sets a callback, \a listener, to be called when receiving a message with the interned \a address.
+	void		setListener( const AddressId &address, ListenerFn listener ) { setListener( address.getAddress(), listener ); }
+	//! Removes the listener associated with the interned \a address.
+	void		removeListener( const AddressId &address ) { removeListener( address.getAddress() ); }
+	//! Sets a callback, \a listener, to be called with messages with \a address, running inline or on
+	//! the receiver's DispatchPool as \a execution says. Listeners that don't run inline get their
+	//! own decoded copy of the message.
+	void		setListener( const std::string &address, ListenerFn listener, Execution execution );
+	//! Sets a callback, \a listener, to be called with messages with \a address, which \a executor runs.
+	void		setListener( const std::string &address, ListenerFn listener, Executor executor );
+	//! Sets the pool that POOL listeners run on. Without one they run inline.
+	void		setDispatchPool( DispatchPoolRef pool );
+	//! Queues decoded messages for poll(), instead of calling inline Message listeners on the
+	//! receiving thread. Up to \a capacity messages are queued, rounded up to a power of two, and
+	//! later ones are dropped. A \a capacity of 0 turns polling off. The queue is single producer,
+	//! so the receiver has to dispatch from one thread at a time. ReceiverUdpSharded therefore
+	//! refuses polling, and on an io_service run from several threads, which only ReceiverTcp
+	//! dispatches concurrently on, messages pushed while another thread pushes are dropped and
+	//! logged. View and non inline listeners still run as they're received.
+	virtual void	setPolling( size_t capacity );
+	//! Calls \a fn, on the calling thread, with up to \a maxCount queued messages and returns how
+	//! many. Only one thread may poll.
+	size_t		poll( const ListenerFn &fn, size_t maxCount = std::numeric_limits<size_t>::max() );
+	//! Calls the inline Message listeners, on the calling thread, with up to \a maxCount queued
+	//! messages and returns how many. Only one thread may poll.
+	size_t		poll( size_t maxCount = std::numeric_limits<size_t>::max() );
+	//! Returns the amount of messages dropped so far because the poll queue was full, or pushed to
+	//! from another thread.
+	size_t		getNumDroppedMessages() const;
+	//! Sets \a table to keep the latest messages of its addresses, alongside calling listeners.
+	//! Addresses that only have a slot aren't reported as lacking a listener.
+	void		setStateTable( StateTableRef table );
+	//! Sets all of \a listeners at once, replacing the ones with the same addresses, to run inline.
+	//! Dispatch sees either none or all of them, and registering many listeners this way is much
+	//! cheaper than one by one.
+	void		setListeners( const Listeners &listeners );
+	//! Sets a callback, \a listener, to be called with a MessageView of messages with \a address,
+	//! which skips decoding them into a Message. The view is only valid during the call. If a view
+	//! listener exists for this address, \a listener will replace it.
+	void		setViewListener( const std::string &address, ViewListenerFn listener );
+	//! Removes the view listener associated with \a address.
+	void		removeViewListener( const std::string &address );
+	//! Sets \a resource, e.g. a MonotonicArena, that the decode scratch grows into instead of the
+	//! global heap. The scratch keeps its capacity from packet to packet, so the resource only sees
+	//! allocations while the scratch warms up, and must not be reset while the receiver listens.
+	//! ReceiverUdpSharded and ReceiverTcp decode into a scratch per socket or connection, which
+	//! stays on the heap. \a resource has to outlive the receiver. Should be set before calling listen().
+	void		setDecodeArena( MemoryResource *resource );
+	//! Returns the amount of type tags that have a cached decode plan. Can be called from any thread.
+	virtual size_t	getDecodePlanCacheSize() const { return mDecodeScratch.mNumPlans.load( std::memory_order_relaxed ); }
+	//! Returns the fraction of messages decoded so far, whose type tag had a cached decode plan.
+	virtual double	getDecodePlanHitRate() const;
 	
 protected:
 	ReceiverBase() = default;
@@ -543,15 +1452,222 @@ protected:
 	//! Non-Moveable.
 	ReceiverBase& operator=( ReceiverBase &&other ) = delete;
 	
-	//! decodes and routes messages from the networking layers stream.
-	void dispatchMethods( uint8_t *data, uint32_t size );
+	//! Alias container for views of the messages in a packet, typical packets fit inline.
+	using MessageViewList = SmallVector<MessageView, 16>;
+	
+	//! The arguments of a type tag, worked out once. When none of them are strings or blobs, their
+	//! offsets are fixed and messages with the tag are decoded by copying all arguments at once and
+	//! swapping them run by run.
+	struct DecodePlan {
+		struct Arg {
+			ArgType		mType;
+			int32_t		mOffset;
+			uint32_t	mSize;
+			bool		mNeedsSwap;
+		};
+		//! A run of adjacent arguments with the same swap size.
+		struct SwapRun {
+			uint32_t	mOffset;
+			uint32_t	mCount;
+			uint32_t	mSize;
+		};
+		
+		std::string				mTypes;
+		std::vector<Arg>		mArgs;
+		std::vector<SwapRun>	mSwapRuns;
+		uint32_t				mArgsSize = 0;
+		bool					mIsFixed = true;
+	};
+	//! The most type tags a scratch keeps decode plans for, later ones are decoded without one.
+	static const size_t sMaxDecodePlans = 64;
+	
+	//! The listeners an incoming address resolves to, in the order they were registered. All are
+	//! empty for an address that nobody listens to.
+	struct AddressMatches {
+		std::vector<uint32_t>	mListeners, mViewListeners;
+		//! The Message listeners that don't run inline.
+		std::vector<uint32_t>	mDeferredListeners;
+		//! The slot of the address in the StateTable, or StateTable::npos.
+		size_t					mStateSlot = StateTable::npos;
+		//! The interned address, which decoded Messages carry. Only set for cached addresses that
+		//! a Message listener is registered with literally.
+		AddressId				mAddressId;
+	};
+	//! The most incoming addresses a scratch keeps resolved, later ones are matched every time.
+	static const size_t sMaxCachedAddresses = 4096;
+	
+	struct ListenerTable;
+	using ListenerTableRef = std::shared_ptr<const ListenerTable>;
+	
+	//! Decoding state that's reused from packet to packet, so that dispatching same shaped traffic
+	//! doesn't allocate once warmed up. Every thread that dispatches needs its own.
+	struct DecodeScratch {
+		//! Views of the messages of the current packet.
+		MessageViewList	mViews;
+		//! The message that Message listeners are called with, cleared for every message while
+		//! keeping its capacity. Listeners therefore must not hold onto it.
+		Message			mMessage;
+		//! Decode plans of the type tags seen so far.
+		std::vector<DecodePlan>	mPlans;
+		size_t			mLastPlan = 0;
+		//! Plan cache statistics. Only the dispatching thread writes them, other threads may read
+		//! them with relaxed loads.
+		std::atomic<size_t>	mNumPlans{ 0 }, mPlanHits{ 0 }, mPlanMisses{ 0 };
+		//! The segments of the address being dispatched, and the listeners that match it.
+		std::vector<std::pair<const char*, size_t>>	mSegments;
+		AddressMatches			mMatches;
+		//! The listener table dispatched to, which is kept alive by holding it, and the version it
+		//! was loaded at.
+		ListenerTableRef		mListenerTable;
+		uint64_t				mListenersVersion = 0;
+		//! Incoming addresses resolved in mListenerTable so far.
+		std::unordered_map<std::string, AddressMatches>	mAddressCache;
+		//! The address being looked up, kept to reuse its capacity.
+		std::string				mAddressKey;
+	};
+	
+	//! A listener address segment with wildcards, compiled once into a bit-parallel NFA with a
+	//! position for every char it consumes. Matching is then a mask update per input char, and
+	//! '*' never backtracks.
+	class SegmentMatcher {
+	public:
+		SegmentMatcher() = default;
+		explicit SegmentMatcher( const std::string &pattern );
+		
+		//! Returns whether the pattern fit into the NFA. Segments that don't are matched with patternMatch.
+		bool isCompiled() const { return mIsCompiled; }
+		//! Returns whether \a segment of \a length chars matches. The pattern has to be compiled.
+		bool match( const char *segment, size_t length ) const;
+		
+		//! The most positions, i.e. chars consumed, a compiled pattern can have.
+		static const size_t sMaxPositions = 64;
+		
+	private:
+		bool compile( const std::string &pattern );
+		
+		//! The literal chars the pattern starts with, checked before running the NFA.
+		std::string				mPrefix;
+		//! Maps every char to its class, the chars that are accepted at the same positions.
+		uint8_t					mClassOf[256];
+		//! The positions accepting each class.
+		std::vector<uint64_t>	mClassPositions;
+		//! The positions that may follow each position.
+		std::vector<uint64_t>	mFollow;
+		uint64_t				mFirst = 0, mLast = 0;
+		bool					mIsNullable = false;
+		bool					mIsValid = false;
+		bool					mIsCompiled = false;
+	};
+	
+	//! A node of the listener address trie, which has a node for every segment of the registered
+	//! addresses. Segments with wildcards are kept apart, as they're matched one by one.
+	struct AddressNode {
+		using Child = std::pair<std::string, std::unique_ptr<AddressNode>>;
+		//! Children of literal segments, sorted to be binary searched.
+		std::vector<Child>		mChildren;
+		//! Children of segments with wildcards.
+		std::vector<Child>		mPatternChildren;
+		//! Indices into mListeners and mViewListeners of the listeners registered at this node.
+		std::vector<uint32_t>	mListeners, mViewListeners;
+		//! The compiled segment of a node that's a pattern child, null for literal children.
+		std::unique_ptr<SegmentMatcher>	mMatcher;
+		//! The id of the Message listener address without wildcards that ends at this node.
+		AddressId				mAddressId;
+	};
+	
+	//! A bounded single producer, single consumer ring of preallocated messages, which are decoded
+	//! into in place. Neither side locks or waits.
+	struct PollQueue {
+		explicit PollQueue( size_t capacity );
+		
+		//! Returns the slot to decode the next message into, or nullptr when full or when another
+		//! thread is pushing. Producer only.
+		Message*	beginPush();
+		//! Ends the push begun by a successful beginPush, publishing the slot if \a publish is true.
+		//! Producer only.
+		void		endPush( bool publish );
+		//! Returns the oldest message, or nullptr when empty. Consumer only.
+		Message*	front();
+		//! Releases the message returned by front. Consumer only.
+		void		pop();
+		
+		std::unique_ptr<Message[]>	mSlots;
+		size_t						mMask;
+		//! The count of messages popped and pushed so far, padded apart to not share a cache line.
+		std::atomic<size_t>			mHead;
+		char						mPadding[64];
+		std::atomic<size_t>			mTail;
+		std::atomic<size_t>			mNumDropped;
+		//! Set between beginPush and endPush, to catch a second producer.
+		std::atomic<bool>			mIsPushing, mReportedConcurrentPush;
+	};
+	
+	//! The listeners and their address trie. A table is immutable once published, changes copy the
+	//! current one and swap the copy in, so dispatch reads it without locking and a table lives
+	//! until the last scratch dispatching to it moves on.
+	struct ListenerTable {
+		//! How a Message listener is run.
+		struct Dispatch {
+			Execution	mExecution;
+			Executor	mExecutor;
+			//! The interned address of a listener without wildcards, set when the table is built
+			//! and carried over to its copies, so that each address is interned once.
+			AddressId	mAddressId;
+		};
+		
+		Listeners				mListeners;
+		//! The Dispatch of each of mListeners.
+		std::vector<Dispatch>	mDispatches;
+		ViewListeners			mViewListeners;
+		AddressNode				mAddressTrie;
+		DispatchPoolRef			mDispatchPool;
+		std::shared_ptr<PollQueue>	mPollQueue;
+		StateTableRef				mStateTable;
+	};
 	
-	//! Decodes a complete OSC Packet into it's individual parts.
-	bool decodeData( uint8_t *data, uint32_t size, std::vector<Message> &messages, uint64_t timetag = 0 ) const;
-	//! Decodes an individual message.
-	bool decodeMessage( uint8_t *data, uint32_t size, std::vector<Message> &messages, uint64_t timetag = 0 ) const;
+	//! decodes and routes messages from the networking layers stream. Receivers that share the
+	//! listeners of another receiver override it to forward to that receiver.
+	virtual void dispatchMethods( uint8_t *data, uint32_t size ) { dispatchMethods( data, size, mDecodeScratch ); }
+	//! decodes and routes messages from the networking layers stream, decoding them into \a scratch.
+	void dispatchMethods( uint8_t *data, uint32_t size, DecodeScratch &scratch );
+	
+	//! Splits a complete OSC Packet into views of it's individual messages.
+	bool decodeData( uint8_t *data, uint32_t size, MessageViewList &views, uint64_t timetag = 0 ) const;
+	//! Decodes an individual message, \a view, into \a message, which is cleared first, using the
+	//! decode plans of \a scratch.
+	bool decodeMessage( const MessageView &view, Message &message, DecodeScratch &scratch ) const;
+	//! Returns the decode plan of the \a numTypes \a types from \a scratch, compiling it if it's new.
+	//! Returns nullptr if the cache is full.
+	const DecodePlan* findDecodePlan( DecodeScratch &scratch, const char *types, size_t numTypes ) const;
+	//! Compiles the decode plan of the \a numTypes \a types.
+	static DecodePlan compileDecodePlan( const char *types, size_t numTypes );
 	//! Matches the addresses of messages based on the OSC spec.
 	bool patternMatch( const std::string &lhs, const std::string &rhs ) const;
+	//! Matches the address \a lhs of \a length chars based on the OSC spec.
+	bool patternMatch( const char *lhs, size_t length, const std::string &rhs ) const;
+	//! Matches the address \a lhs of \a lhsLength chars with the pattern \a rhs of \a rhsLength chars
+	//! based on the OSC spec.
+	bool patternMatch( const char *lhs, size_t lhsLength, const char *rhs, size_t rhsLength ) const;
+	//! Sets \a listener for \a address in \a table, replacing the one with the same address.
+	static void setListener( ListenerTable &table, const std::string &address, ListenerFn listener, ListenerTable::Dispatch dispatch );
+	//! Calls the listeners of the message in \a view that don't run inline, with a copy of it.
+	void dispatchDeferred( const MessageView &view, const AddressMatches &matches, DecodeScratch &scratch ) const;
+	//! Loads the current listener table into \a scratch when it has changed since the last time.
+	void loadListenerTable( DecodeScratch &scratch ) const;
+	//! Publishes a copy of the current listener table, which \a update has changed, as the new one.
+	void updateListeners( const std::function<void( ListenerTable &table )> &update );
+	//! Adds the listener at \a index of mListeners, or of mViewListeners if \a isView, to the address
+	//! trie of \a table. \a segments is reused to split \a address.
+	static void insertListener( ListenerTable &table, const std::string &address, uint32_t index, bool isView,
+								std::vector<std::pair<const char*, size_t>> &segments );
+	//! Builds the address trie of \a table from its listeners.
+	static void buildAddressTrie( ListenerTable &table );
+	//! Returns the listeners of the scratch's table that match \a address of \a length chars, from
+	//! the address cache of \a scratch when it's been seen before.
+	const AddressMatches& resolveAddress( const char *address, size_t length, DecodeScratch &scratch ) const;
+	//! Collects the listeners below \a node, whose addresses match the address segments of \a scratch
+	//! from \a depth on.
+	void matchListeners( const AddressNode &node, DecodeScratch &scratch, size_t depth ) const;
 	
 	//! Abstract bind implementation function.
 	virtual void bindImpl() = 0;
@@ -560,8 +1676,15 @@ protected:
 	//! Abstract close implementation function.
 	virtual void closeImpl() = 0;
 	
-	Listeners				mListeners;
+	//! The published listener table, only accessed with std::atomic_load and std::atomic_store.
+	ListenerTableRef		mListenerTable = ListenerTableRef( new ListenerTable );
+	//! Bumped after every new table, so dispatch only loads the table when it has changed.
+	std::atomic<uint64_t>	mListenersVersion{ 0 };
+	//! Serializes the changes of the listener table, dispatch doesn't take it.
 	std::mutex				mListenerMutex, mSocketTransportErrorFnMutex;
+	DecodeScratch			mDecodeScratch;
+	//! The scratch of the polling thread.
+	DecodeScratch			mPollScratch;
 };
 	
 //! Represents an OSC Receiver(called a \a client in the OSC spec) and implements the UDP transport
@@ -587,7 +1710,19 @@ public:
 	virtual ~ReceiverUdp() = default;
 	
 	// TODO: Check to see that this is needed, see if we can't auto accept a size of datagram.
-	void setAmountToReceive( uint32_t amountToReceive ) { mAmountToReceive = amountToReceive; }
+	//! Sets the size of each receive buffer, which is the largest datagram that can be received.
+	//! Should be set before calling listen().
+	void setAmountToReceive( uint32_t amountToReceive ) { mAmountToReceive = amountToReceive; mReceiveStorage.reset(); }
+	//! Sets the amount of receive buffers in the ring, defaults to 4. While a datagram is dispatched,
+	//! the next one is already received into a free buffer. Batch receive uses at least as many
+	//! buffers as its batch size. Should be set before calling listen().
+	void setReceiveBufferCount( size_t count ) { mReceiveBuffers.resize( std::max<size_t>( count, 1 ) ); mReceiveStorage.reset(); }
+	//! Enables draining up to \a batchSize datagrams per wakeup with a single recvmmsg call, which are
+	//! all dispatched before receiving again. A \a batchSize of 0 disables batching. With \a useGro,
+	//! the kernel may coalesce datagrams of the same size into one buffer, which needs the amount to
+	//! receive to be large enough to hold them. Only supported on Linux, elsewhere logs a warning and
+	//! keeps receiving one datagram at a time. Should be set before calling listen().
+	void setBatchReceive( size_t batchSize, bool useGro = false );
 	//! Returns the local udp::endpoint of the underlying socket.
 	asio::ip::udp::endpoint getLocalEndpoint() { return mSocket->local_endpoint(); }
 	
@@ -601,14 +1736,39 @@ protected:
 	void listenImpl() override;
 	//! Closes the underlying UDP socket.
 	void closeImpl() override { mSocket->close(); }
+	//! Allocates the storage of all receive buffers at once, aligned to cache lines.
+	void allocateReceiveBuffers();
+	//! Handles the completion of a receive into the buffer at \a index.
+	void onReceive( size_t index, const asio::error_code &error, size_t bytesTransferred );
+	//! Waits for the socket to become readable and then receives a batch of datagrams.
+	void listenBatch();
+	//! Receives and dispatches up to a batch of datagrams, that are ready on the socket.
+	void receiveBatch();
+	
+	//! Holds the platform's batch receive structures.
+	struct BatchState;
+	
+	//! A slot of the receive ring, the datagram and its sender are received into.
+	struct ReceiveBuffer {
+		uint8_t					*mData = nullptr;
+		asio::ip::udp::endpoint	mEndpoint;
+		bool					mInUse = false;
+	};
 	
 	UdpSocketRef						mSocket;
 	asio::ip::udp::endpoint				mLocalEndpoint;
-	asio::streambuf						mBuffer;
 	
 	SocketTransportErrorFn<protocol>	mSocketTransportErrorFn;
 	
 	uint32_t							mAmountToReceive;
+	std::unique_ptr<uint8_t[]>			mReceiveStorage;
+	std::vector<ReceiveBuffer>			mReceiveBuffers;
+	size_t								mNextReceiveBuffer = 0;
+	bool								mIsReceiving = false;
+	std::mutex							mReceiveMutex, mDispatchMutex;
+	size_t								mBatchSize = 0;
+	bool								mUseGro = false;
+	std::shared_ptr<BatchState>			mBatchState;
 	
 public:
 	//! Non-copyable.
@@ -621,6 +1781,80 @@ public:
 	ReceiverUdp& operator=( ReceiverUdp &&other ) = delete;
 };
 
+//! Represents an OSC Receiver(called a \a client in the OSC spec) that spreads the UDP transport
+//! networking layer over several sockets bound to the same port with SO_REUSEPORT. The kernel
+//! hashes the incoming flows across the sockets, each of which receives and decodes on its own
+//! thread and io_service. All of them dispatch to this receiver's listeners, which therefore may be
+//! called from any of the threads. Each socket decodes into its own scratch.
+class ReceiverUdpSharded : public ReceiverBase {
+public:
+	using protocol = asio::ip::udp;
+	//! Constructs a sharded Receiver of \a numShards sockets, whose local endpoint is defined by
+	//! \a localPort and \a protocol, which defaults to v4. A \a numShards of 0 creates one for each
+	//! hardware thread. Where SO_REUSEPORT isn't available, a single socket is used.
+	ReceiverUdpSharded( uint16_t port, size_t numShards = 0, const protocol &protocol = protocol::v4() );
+	//! Constructs a sharded Receiver of \a numShards sockets, whose local endpoint is defined by \a localEndpoint.
+	ReceiverUdpSharded( const protocol::endpoint &localEndpoint, size_t numShards = 0 );
+	//! Closes the sockets and joins their threads.
+	virtual ~ReceiverUdpSharded();
+	
+	//! Returns the amount of sockets receiving on the port.
+	size_t	getNumShards() const { return mShards.size(); }
+	//! Returns the amount of type tags that have a cached decode plan, summed over all sockets.
+	size_t	getDecodePlanCacheSize() const override;
+	//! Returns the fraction of messages decoded so far, whose type tag had a cached decode plan.
+	double	getDecodePlanHitRate() const override;
+	//! Sets the amount to receive of every socket, see ReceiverUdp::setAmountToReceive.
+	void	setAmountToReceive( uint32_t amountToReceive );
+	//! Sets the batch receive mode of every socket, see ReceiverUdp::setBatchReceive.
+	void	setBatchReceive( size_t batchSize, bool useGro = false );
+	//! Sets the underlying SocketTransportErrorFn of every socket.
+	void	setSocketErrorFn( SocketTransportErrorFn<protocol> errorFn );
+	//! Polling isn't supported, the sockets dispatch from a thread each but the poll queue takes a
+	//! single producer. Logs an error and leaves polling off.
+	void	setPolling( size_t capacity ) override;
+	
+protected:
+	//! A single socket of the receiver, that forwards the packets it receives to its owner.
+	class Shard : public ReceiverUdp {
+	public:
+		Shard( ReceiverUdpSharded *owner, const protocol::endpoint &localEndpoint, asio::io_service &io );
+		
+	protected:
+		//! Opens the socket, allows reusing the port and binds it.
+		void bindImpl() override;
+		//! Dispatches through the owner's listeners, decoding into this shard's scratch.
+		void dispatchMethods( uint8_t *data, uint32_t size ) override { mOwner->dispatchMethods( data, size, mDecodeScratch ); }
+		
+		ReceiverUdpSharded*	mOwner;
+		
+		friend class ReceiverUdpSharded;
+	};
+	
+	//! Creates \a numShards shards bound to \a localEndpoint, each with its own io_service.
+	void createShards( const protocol::endpoint &localEndpoint, size_t numShards );
+	//! Binds all sockets to the local endpoint.
+	void bindImpl() override;
+	//! Starts listening on all sockets, each on its own thread.
+	void listenImpl() override;
+	//! Closes all sockets and joins their threads, once the aborted receives have completed.
+	void closeImpl() override;
+	
+	std::vector<std::unique_ptr<asio::io_service>>	mServices;
+	std::vector<std::unique_ptr<Shard>>				mShards;
+	std::vector<std::thread>						mThreads;
+	
+public:
+	//! Non-copyable.
+	ReceiverUdpSharded( const ReceiverUdpSharded &other ) = delete;
+	//! Non-copyable.
+	ReceiverUdpSharded& operator=( const ReceiverUdpSharded &other ) = delete;
+	//! Non-Moveable.
+	ReceiverUdpSharded( ReceiverUdpSharded &&other ) = delete;
+	//! Non-Moveable.
+	ReceiverUdpSharded& operator=( ReceiverUdpSharded &&other ) = delete;
+};
+
 //! Represents an OSC Receiver(called a \a client in the OSC spec) and implements the TCP
 //! transport networking layer.
 class ReceiverTcp : public ReceiverBase {
@@ -643,6 +1877,10 @@ public:
 	
 	//! Sets the underlying SocketTransportErrorFn based on the asio::io::tcp protocol.
 	void setSocketTransportErrorFn( SocketTransportErrorFn<protocol> errorFn );
+	//! Returns the amount of type tags that have a cached decode plan, summed over all connections.
+	size_t	getDecodePlanCacheSize() const override;
+	//! Returns the fraction of messages decoded so far, whose type tag had a cached decode plan.
+	double	getDecodePlanHitRate() const override;
 	
 protected:
 	struct Connection {
@@ -666,6 +1904,8 @@ protected:
 		ReceiverTcp*			mReceiver;
 		asio::streambuf			mBuffer;
 		std::vector<uint8_t>	mDataBuffer;
+		//! Every connection dispatches with its own scratch, so connections don't wait on each other.
+		DecodeScratch			mDecodeScratch;
 		
 		//! Non-copyable.
 		Connection( const Connection &other ) = delete;
@@ -693,7 +1933,7 @@ protected:
 	
 	SocketTransportErrorFn<protocol>	mSocketTransportErrorFn;
 	
-	std::mutex							mDispatchMutex, mConnectionMutex;
+	mutable std::mutex					mConnectionMutex;
 	
 	using UniqueConnection = std::unique_ptr<Connection>;
 	std::vector<UniqueConnection>			mConnections;
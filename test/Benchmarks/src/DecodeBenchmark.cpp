@@ -0,0 +1,102 @@
+// Compares the vectorized null terminator scan against scanning a byte at a time, which is how
+// the decoder found the end of addresses, type tags and strings before, and times decoding whole
+// messages with short and long addresses and strings. Osc.cpp is compiled into this file so the
+// benchmark can reach its internal kernels:
+//
+//	c++ -std=c++11 -O2 [-mavx2] -I../../../src -I<cinder>/include DecodeBenchmark.cpp -o DecodeBenchmark
+
+#include "Osc.cpp"
+
+#include <chrono>
+#include <iostream>
+
+using namespace std;
+
+namespace {
+
+//! Scans for the null terminator one byte at a time, like the decoder used to.
+size_t findNullEachByte( const uint8_t *data, size_t size )
+{
+	size_t i = 0;
+	while( i < size && data[i] != '\0' )
+		++i;
+	return i;
+}
+
+//! Dispatches encoded packets straight to its listeners, without a socket.
+class LoopbackReceiver : public osc::ReceiverBase {
+public:
+	void dispatch( std::vector<uint8_t> &packet ) { dispatchMethods( packet.data(), static_cast<uint32_t>( packet.size() ) ); }
+
+protected:
+	void bindImpl() override {}
+	void listenImpl() override {}
+	void closeImpl() override {}
+};
+
+//! Returns the encoding of \a message, without a size prefix.
+std::vector<uint8_t> encode( const osc::Message &message )
+{
+	std::vector<uint8_t> packet( message.encodedSize() );
+	message.encodeInto( packet.data(), packet.size() );
+	return packet;
+}
+
+//! Returns the average ns of scanning every null terminated string of \a packet with \a findFn.
+template<typename FindFn>
+double measureScan( const std::vector<uint8_t> &packet, FindFn findFn, size_t iterations, size_t &checksum )
+{
+	auto start = std::chrono::steady_clock::now();
+	for( size_t i = 0; i < iterations; i++ ) {
+		size_t offset = 0;
+		while( offset < packet.size() ) {
+			auto length = findFn( packet.data() + offset, packet.size() - offset );
+			checksum += length;
+			offset += ( length + 4 ) & ~size_t( 3 );
+		}
+	}
+	return std::chrono::duration<double, nano>( std::chrono::steady_clock::now() - start ).count() / iterations;
+}
+
+void run( const char *name, const std::string &address, const std::string &text )
+{
+	osc::Message message( address );
+	message.append( 1.0f );
+	message.append( text );
+	message.append( int32_t( 7 ) );
+	message.append( text );
+	auto packet = encode( message );
+	
+	const size_t iterations = 1000000;
+	size_t eachByteChecksum = 0, vectorizedChecksum = 0;
+	auto eachByte = measureScan( packet, findNullEachByte, iterations, eachByteChecksum );
+	auto vectorized = measureScan( packet, osc::findNull, iterations, vectorizedChecksum );
+	if( eachByteChecksum != vectorizedChecksum )
+		cerr << name << ": the scans disagree" << endl;
+	
+	LoopbackReceiver receiver;
+	size_t sum = 0;
+	receiver.setListener( address, [&sum]( const osc::Message &decoded ) {
+		sum += decoded.getArgInt( 2 ) + decoded.getArgString( 1 ).size();
+	});
+	auto start = std::chrono::steady_clock::now();
+	for( size_t i = 0; i < iterations; i++ )
+		receiver.dispatch( packet );
+	auto decode = std::chrono::duration<double, nano>( std::chrono::steady_clock::now() - start ).count() / iterations;
+	if( sum != iterations * ( 7 + text.size() ) )
+		cerr << name << ": decoded the wrong arguments" << endl;
+	
+	cout << name << " (" << packet.size() << " bytes): scan per byte " << eachByte << " ns, vectorized "
+		<< vectorized << " ns, " << eachByte / vectorized << "x, decode and dispatch " << decode << " ns" << endl;
+}
+
+} // anonymous namespace
+
+int main()
+{
+	run( "short address, short text", "/a/b", "on" );
+	run( "long address, short text", "/fixture/group/12/channel/7/intensity", "on" );
+	run( "short address, long text", "/label", "a moderately long text value for a label" );
+	run( "long address, long text", "/show/stage/left/rig/truss/3/fixture/moving_head/42/params/pan_tilt/fine",
+		std::string( 200, 'x' ) );
+}
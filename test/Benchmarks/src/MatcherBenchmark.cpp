@@ -0,0 +1,170 @@
+// Checks the compiled address segment matcher against patternMatch and against a backtracking
+// reference matcher on random patterns, then times matching an address against 4000 patterns
+// with both. Osc.cpp is compiled into this file so the benchmark can reach the matcher:
+//
+//	c++ -std=c++11 -O2 -I../../../src -I<cinder>/include MatcherBenchmark.cpp -o MatcherBenchmark
+
+#include "Osc.cpp"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+using namespace std;
+
+namespace {
+
+//! Exposes the matchers of ReceiverBase.
+class MatcherReceiver : public osc::ReceiverBase {
+public:
+	using ReceiverBase::patternMatch;
+	using Matcher = SegmentMatcher;
+
+protected:
+	void bindImpl() override {}
+	void listenImpl() override {}
+	void closeImpl() override {}
+};
+
+//! Matches the \a segment of [s, se) against the pattern [p, pe) by backtracking over every
+//! alternative, which is slow but follows the OSC spec to the letter.
+bool referenceMatch( const char *s, const char *se, const char *p, const char *pe )
+{
+	if( p == pe )
+		return s == se;
+	switch( *p ) {
+		case '*':
+			for( const char *t = s; ; ++t ) {
+				if( referenceMatch( t, se, p + 1, pe ) )
+					return true;
+				if( t == se )
+					return false;
+			}
+		case '?':
+			return s != se && referenceMatch( s + 1, se, p + 1, pe );
+		case '[': {
+			const char *q = p + 1;
+			bool negate = q != pe && *q == '!';
+			if( negate )
+				++q;
+			bool found = false;
+			while( q != pe && *q != ']' ) {
+				if( pe - q > 2 && q[1] == '-' && q[2] != ']' ) {
+					char low = std::min( q[0], q[2] ), high = std::max( q[0], q[2] );
+					found |= s != se && *s >= low && *s <= high;
+					q += 3;
+				}
+				else {
+					found |= s != se && *s == *q;
+					++q;
+				}
+			}
+			if( q == pe || s == se )
+				return false;
+			return found != negate && referenceMatch( s + 1, se, q + 1, pe );
+		}
+		case '{': {
+			const char *close = std::find( p, pe, '}' );
+			if( close == pe )
+				return false;
+			for( const char *begin = p + 1; ; ) {
+				const char *end = begin;
+				while( *end != ',' && *end != '}' )
+					++end;
+				size_t length = end - begin;
+				if( size_t( se - s ) >= length && std::equal( begin, end, s ) && referenceMatch( s + length, se, close + 1, pe ) )
+					return true;
+				if( *end == '}' )
+					return false;
+				begin = end + 1;
+			}
+		}
+		default:
+			return s != se && *s == *p && referenceMatch( s + 1, se, p + 1, pe );
+	}
+}
+
+//! Returns false after reporting the first of random patterns and segments that the compiled
+//! matcher disagrees on with the reference, or with patternMatch where it has no '*' or '{'.
+bool checkMatchers( const MatcherReceiver &receiver )
+{
+	const char *atoms[] = { "a", "b", "c", "?", "*", "[ab]", "[!a]", "[a-b]", "[c-a]", "{a,bc}", "{ab,,c}", "{b,ab,abc}" };
+	const size_t numAtoms = sizeof( atoms ) / sizeof( atoms[0] );
+	std::mt19937 random( 7 );
+	size_t numCases = 0, numPatternMatchCases = 0;
+	for( int i = 0; i < 20000; i++ ) {
+		std::string pattern;
+		for( int length = random() % 5 + 1; length > 0; --length )
+			pattern += atoms[random() % numAtoms];
+		MatcherReceiver::Matcher matcher( pattern );
+		if( ! matcher.isCompiled() ) {
+			cerr << "'" << pattern << "' didn't compile" << endl;
+			return false;
+		}
+		bool checkPatternMatch = pattern.find_first_of( "*{" ) == std::string::npos;
+		for( int j = 0; j < 20; j++ ) {
+			std::string segment;
+			for( int length = random() % 7; length > 0; --length )
+				segment += "abc"[random() % 3];
+			bool expected = referenceMatch( segment.data(), segment.data() + segment.size(), pattern.data(), pattern.data() + pattern.size() );
+			bool compiled = matcher.match( segment.data(), segment.size() );
+			if( compiled != expected ) {
+				cerr << "'" << pattern << "' on '" << segment << "': compiled " << compiled << ", expected " << expected << endl;
+				return false;
+			}
+			// patternMatch backtracks only partly on '*' and '{', so it's the oracle without them.
+			if( checkPatternMatch && receiver.patternMatch( segment, pattern ) != expected ) {
+				cerr << "'" << pattern << "' on '" << segment << "': patternMatch " << ! expected << ", expected " << expected << endl;
+				return false;
+			}
+			numPatternMatchCases += checkPatternMatch;
+			++numCases;
+		}
+	}
+	cout << "matchers agree on " << numCases << " cases, " << numPatternMatchCases << " checked against patternMatch" << endl;
+	return true;
+}
+
+void benchmark( const MatcherReceiver &receiver )
+{
+	std::vector<std::string> patterns;
+	std::vector<MatcherReceiver::Matcher> matchers;
+	// patternMatch handles this shape of pattern correctly, so both matchers find the same matches.
+	for( int i = 0; i < 4000; i++ ) {
+		patterns.push_back( "ch" + std::to_string( i ) + "*7{x,y}" );
+		matchers.emplace_back( patterns.back() );
+	}
+	const std::string segment = "ch3999abc7y";
+	const size_t iterations = 200;
+	size_t patternMatchHits = 0, compiledHits = 0;
+	
+	auto start = std::chrono::steady_clock::now();
+	for( size_t i = 0; i < iterations; i++ ) {
+		for( auto & pattern : patterns )
+			patternMatchHits += receiver.patternMatch( segment.data(), segment.size(), pattern.data(), pattern.size() );
+	}
+	auto patternMatchTime = std::chrono::duration<double, nano>( std::chrono::steady_clock::now() - start ).count();
+	
+	start = std::chrono::steady_clock::now();
+	for( size_t i = 0; i < iterations; i++ ) {
+		for( auto & matcher : matchers )
+			compiledHits += matcher.match( segment.data(), segment.size() );
+	}
+	auto compiledTime = std::chrono::duration<double, nano>( std::chrono::steady_clock::now() - start ).count();
+	
+	if( patternMatchHits != compiledHits )
+		cerr << "patternMatch matched " << patternMatchHits << " times, the compiled matcher " << compiledHits << endl;
+	auto numMatches = double( iterations * patterns.size() );
+	cout << patterns.size() << " patterns: patternMatch " << patternMatchTime / numMatches << " ns, compiled "
+		<< compiledTime / numMatches << " ns per pattern, " << patternMatchTime / compiledTime << "x" << endl;
+}
+
+} // anonymous namespace
+
+int main()
+{
+	MatcherReceiver receiver;
+	if( ! checkMatchers( receiver ) )
+		return 1;
+	benchmark( receiver );
+}
@@ -0,0 +1,111 @@
+// Compares the argument byte swap kernel against swapping one argument at a time, which is how
+// Message converted its arguments before runs of them were swapped in batches. Osc.cpp is
+// compiled into this file so the benchmark can reach its internal kernels:
+//
+//	c++ -std=c++11 -O2 [-mavx2] -I../../../src -I<cinder>/include SwapBenchmark.cpp -o SwapBenchmark
+
+#include "Osc.cpp"
+
+#include <chrono>
+#include <iostream>
+
+using namespace std;
+
+namespace {
+
+//! Swaps every argument on its own, like Argument::swapEndianForTransmit used to.
+void swapEachArgument( const osc::Message::Argument *begin, const osc::Message::Argument *end, uint8_t *buffer )
+{
+	for( auto it = begin; it != end; ++it ) {
+		auto ptr = buffer + it->getOffset();
+		switch( it->getType() ) {
+			case osc::ArgType::INTEGER_32:
+			case osc::ArgType::CHAR:
+			case osc::ArgType::BLOB: {
+				int32_t a = htonl( *reinterpret_cast<int32_t*>( ptr ) );
+				memcpy( ptr, &a, sizeof( int32_t ) );
+			}
+			break;
+			case osc::ArgType::INTEGER_64:
+			case osc::ArgType::TIME_TAG: {
+				uint64_t a = htonll( *reinterpret_cast<uint64_t*>( ptr ) );
+				memcpy( ptr, &a, sizeof( uint64_t ) );
+			}
+			break;
+			case osc::ArgType::FLOAT: {
+				int32_t a = osc::htonf( *reinterpret_cast<float*>( ptr ) );
+				memcpy( ptr, &a, sizeof( float ) );
+			}
+			break;
+			case osc::ArgType::DOUBLE: {
+				int64_t a = osc::htond( *reinterpret_cast<double*>( ptr ) );
+				memcpy( ptr, &a, sizeof( double ) );
+			}
+			break;
+			default: break;
+		}
+	}
+}
+
+template<typename SwapFn>
+double measure( const osc::Message &message, size_t numArgs, SwapFn swapFn, size_t iterations )
+{
+	vector<uint8_t> packet( message.encodedSize() );
+	message.encodeInto( packet.data(), packet.size() );
+	// the arguments' offsets are relative to the data that follows the address and type tags.
+	auto data = packet.data();
+	for( int i = 0; i < 2; i++ )
+		data += ( strlen( reinterpret_cast<const char*>( data ) ) + 4 ) & ~size_t( 3 );
+	auto begin = &message[0];
+	auto end = begin + numArgs;
+	
+	auto start = std::chrono::steady_clock::now();
+	for( size_t i = 0; i < iterations; i++ )
+		swapFn( begin, end, data );
+	auto elapsed = std::chrono::duration<double, nano>( std::chrono::steady_clock::now() - start ).count();
+	
+	// both paths are their own inverse, so an even number of iterations leaves the data intact.
+	vector<uint8_t> check( packet.size() );
+	message.encodeInto( check.data(), check.size() );
+	if( iterations % 2 == 0 && check != packet )
+		cerr << "swap changed the data" << endl;
+	return elapsed / iterations;
+}
+
+void run( const char *name, const osc::Message &message, size_t numArgs )
+{
+	const size_t iterations = 2000000;
+	auto perArgument = measure( message, numArgs, swapEachArgument, iterations );
+	auto batched = measure( message, numArgs, osc::swapArgumentRuns, iterations );
+	cout << name << ": per argument " << perArgument << " ns, batched " << batched << " ns, "
+		<< perArgument / batched << "x" << endl;
+}
+
+} // anonymous namespace
+
+int main()
+{
+	osc::Message floats( "/sensor/frame" );
+	for( int i = 0; i < 64; i++ )
+		floats.append( float( i ) );
+	run( "64 floats", floats, 64 );
+	
+	osc::Message doubles( "/sensor/frame" );
+	for( int i = 0; i < 32; i++ )
+		doubles.append( double( i ) );
+	run( "32 doubles", doubles, 32 );
+	
+	osc::Message fixture( "/fixture/1/color" );
+	fixture.append( int32_t( 1 ) );
+	for( int i = 0; i < 12; i++ )
+		fixture.append( float( i ) / 12.0f );
+	fixture.append( "rgb" );
+	for( int i = 0; i < 4; i++ )
+		fixture.append( int64_t( i ) );
+	run( "mixed fixture", fixture, 18 );
+	
+	osc::Message small( "/fader" );
+	small.append( 0.5f );
+	small.append( int32_t( 3 ) );
+	run( "2 arguments", small, 2 );
+}
@@ -0,0 +1,77 @@
+#include "UnitTest.h"
+
+using namespace std;
+
+namespace {
+
+//! Dispatches messages to a receiver, which resolves their addresses through its cache.
+class CacheFixture {
+public:
+	void dispatch( const std::string &address )
+	{
+		mSender.send( osc::Message( address, 1 ) );
+		mReceiver.dispatch( mSender.getLastPacket() );
+	}
+	
+	test::LoopbackReceiver	mReceiver;
+	test::CaptureSender		mSender;
+};
+
+} // anonymous namespace
+
+OSC_TEST( changingListenersInvalidatesTheCache )
+{
+	CacheFixture fixture;
+	int a = 0, b = 0;
+	fixture.mReceiver.setListener( "/a/*", [&]( const osc::Message & ) {
+		a++;
+	});
+	for( int i = 0; i < 5; i++ )
+		fixture.dispatch( "/a/x" );
+	OSC_CHECK( a == 5 );
+	
+	// an address without a listener is cached too, until one is registered.
+	for( int i = 0; i < 5; i++ )
+		fixture.dispatch( "/nobody" );
+	fixture.mReceiver.setListener( "/nobody", [&]( const osc::Message & ) {
+		b++;
+	});
+	fixture.dispatch( "/nobody" );
+	OSC_CHECK( b == 1 );
+	
+	fixture.mReceiver.removeListener( "/a/*" );
+	fixture.dispatch( "/a/x" );
+	OSC_CHECK( a == 5 );
+	fixture.mReceiver.setListener( "/a/x", [&]( const osc::Message & ) {
+		a += 10;
+	});
+	fixture.dispatch( "/a/x" );
+	OSC_CHECK( a == 15 );
+	// replacing the callback of an address calls the new one.
+	fixture.mReceiver.setListener( "/a/x", [&]( const osc::Message & ) {
+		a += 100;
+	});
+	fixture.dispatch( "/a/x" );
+	OSC_CHECK( a == 115 );
+	// as do view listeners, which share the cache.
+	int views = 0;
+	fixture.mReceiver.setViewListener( "/a/?", [&]( const osc::MessageView & ) {
+		views++;
+	});
+	fixture.dispatch( "/a/x" );
+	OSC_CHECK( a == 215 && views == 1 );
+}
+
+OSC_TEST( addressesBeyondTheCacheStillDispatch )
+{
+	CacheFixture fixture;
+	int numReceived = 0;
+	fixture.mReceiver.setListener( "/fixture/*", [&]( const osc::Message & ) {
+		numReceived++;
+	});
+	// more distinct addresses than the cache keeps, twice over.
+	for( int round = 0; round < 2; round++ )
+		for( int i = 0; i < 5000; i++ )
+			fixture.dispatch( "/fixture/" + std::to_string( i ) );
+	OSC_CHECK( numReceived == 10000 );
+}
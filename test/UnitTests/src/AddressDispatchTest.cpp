@@ -0,0 +1,100 @@
+#include "UnitTest.h"
+
+using namespace std;
+
+namespace {
+
+//! Records which listener addresses each dispatched address reaches, in the order they're called.
+class DispatchLog {
+public:
+	//! Registers a listener for \a address that logs it.
+	void add( const std::string &address )
+	{
+		mReceiver.setListener( address, [this, address]( const osc::Message & ) {
+			mCalled.push_back( address );
+		});
+	}
+	//! Dispatches a message to \a address and returns the listener addresses called.
+	const std::vector<std::string>& dispatch( const std::string &address )
+	{
+		mCalled.clear();
+		mSender.send( osc::Message( address, 1 ) );
+		mReceiver.dispatch( mSender.getLastPacket() );
+		return mCalled;
+	}
+	
+	test::LoopbackReceiver		mReceiver;
+	test::CaptureSender			mSender;
+	std::vector<std::string>	mCalled;
+};
+
+} // anonymous namespace
+
+OSC_TEST( listenerPatternsMatchBySegment )
+{
+	DispatchLog log;
+	log.add( "/a/b" );
+	log.add( "/a/*" );
+	log.add( "/a/b/c" );
+	log.add( "/x/[0-9]/y" );
+	log.add( "/x/{foo,bar}/z" );
+	log.add( "/q*" );
+	log.add( "/a/[!b]" );
+	
+	// listeners are called in the order they were registered.
+	OSC_CHECK( log.dispatch( "/a/b" ) == std::vector<std::string>( { "/a/b", "/a/*" } ) );
+	OSC_CHECK( log.dispatch( "/a/c" ) == std::vector<std::string>( { "/a/*", "/a/[!b]" } ) );
+	// a wildcard doesn't match across segments.
+	OSC_CHECK( log.dispatch( "/a/b/c" ) == std::vector<std::string>( { "/a/b/c" } ) );
+	OSC_CHECK( log.dispatch( "/a" ).empty() );
+	OSC_CHECK( log.dispatch( "/x/5/y" ).size() == 1 );
+	OSC_CHECK( log.dispatch( "/x/a/y" ).empty() );
+	OSC_CHECK( log.dispatch( "/x/bar/z" ).size() == 1 );
+	OSC_CHECK( log.dispatch( "/x/baz/z" ).empty() );
+	OSC_CHECK( log.dispatch( "/q" ).size() == 1 );
+	OSC_CHECK( log.dispatch( "/qqq" ).size() == 1 );
+}
+
+OSC_TEST( incomingPatternsMatchListenerAddresses )
+{
+	DispatchLog log;
+	log.add( "/a/b" );
+	log.add( "/a/*" );
+	log.add( "/a/b/c" );
+	log.add( "/x/5/y" );
+	
+	OSC_CHECK( log.dispatch( "/a/?" ) == std::vector<std::string>( { "/a/b" } ) );
+	OSC_CHECK( log.dispatch( "/a/*" ) == std::vector<std::string>( { "/a/b", "/a/*" } ) );
+	OSC_CHECK( log.dispatch( "/*/b" ) == std::vector<std::string>( { "/a/b", "/a/*" } ) );
+	OSC_CHECK( log.dispatch( "/*/*/*" ) == std::vector<std::string>( { "/a/b/c", "/x/5/y" } ) );
+	OSC_CHECK( log.dispatch( "/x/[0-4]/y" ).empty() );
+	// malformed patterns match nothing.
+	OSC_CHECK( log.dispatch( "/a/[b" ).empty() );
+	OSC_CHECK( log.dispatch( "/a/{b" ).empty() );
+}
+
+OSC_TEST( changingListenersRebuildsTheTrie )
+{
+	DispatchLog log;
+	log.add( "/a/b" );
+	log.add( "/a/*" );
+	log.mReceiver.removeListener( "/a/b" );
+	OSC_CHECK( log.dispatch( "/a/b" ) == std::vector<std::string>( { "/a/*" } ) );
+	// registered again, it's called last.
+	log.add( "/a/b" );
+	OSC_CHECK( log.dispatch( "/a/b" ) == std::vector<std::string>( { "/a/*", "/a/b" } ) );
+	
+	// among thousands of addresses only the matching one is called. Each change rebuilds the
+	// trie, so register them all at once.
+	osc::ReceiverBase::Listeners fixtures;
+	for( int i = 0; i < 5000; i++ ) {
+		auto address = "/fixture/" + std::to_string( i ) + "/level";
+		fixtures.push_back( { address, [&log, address]( const osc::Message & ) {
+			log.mCalled.push_back( address );
+		} } );
+	}
+	log.mReceiver.setListeners( fixtures );
+	OSC_CHECK( log.dispatch( "/fixture/1234/level" ) == std::vector<std::string>( { "/fixture/1234/level" } ) );
+	OSC_CHECK( log.dispatch( "/fixture/12345/level" ).empty() );
+	OSC_CHECK( log.dispatch( "/fixture/4999/*" ).size() == 1 );
+}
@@ -0,0 +1,89 @@
+#include "UnitTest.h"
+
+#include <thread>
+
+using namespace std;
+using namespace osc::literals;
+
+namespace {
+
+constexpr auto sFader = "/mixer/1/fader"_osc;
+static_assert( sFader.mHash == osc::hashAddress( "/mixer/1/fader", 14 ), "literals are hashed at compile time" );
+static_assert( sFader.mLength == 14, "literals know their length" );
+
+} // anonymous namespace
+
+OSC_TEST( addressIdsAreInterned )
+{
+	osc::AddressId fader = sFader, same( std::string( "/mixer/1/fader" ) ), other = "/other"_osc;
+	OSC_CHECK( fader == same && fader != other );
+	OSC_CHECK( fader.isValid() && ! osc::AddressId().isValid() );
+	OSC_CHECK( fader.getAddress() == "/mixer/1/fader" && osc::AddressId().getAddress().empty() );
+	
+	osc::Message message( fader );
+	message.append( 1 );
+	osc::Message byString( "/mixer/1/fader", 1 );
+	OSC_CHECK( message.getAddress() == "/mixer/1/fader" && message.getAddressId() == fader );
+	OSC_CHECK( message == byString && byString.getAddressId() == fader );
+	byString.setAddress( "/other" );
+	OSC_CHECK( message != byString && byString.getAddressId() == other );
+}
+
+OSC_TEST( addressIdsAreInternedOnceAcrossThreads )
+{
+	std::vector<std::thread> threads;
+	std::vector<uint32_t> values( 8 );
+	for( size_t t = 0; t < values.size(); t++ ) {
+		threads.emplace_back( [&values, t] {
+			for( int i = 0; i < 1000; i++ ) {
+				osc::AddressId id( "/concurrent/" + std::to_string( i ) );
+				if( i == 500 )
+					values[t] = id.getValue();
+			}
+		});
+	}
+	for( auto & thread : threads )
+		thread.join();
+	for( auto value : values )
+		OSC_CHECK( value == values[0] );
+}
+
+OSC_TEST( decodedMessagesCarryTheListenerId )
+{
+	test::CaptureSender sender;
+	test::LoopbackReceiver receiver;
+	osc::AddressId fader = sFader;
+	std::vector<osc::AddressId> received;
+	receiver.setListener( "/mixer/*/fader", [&]( const osc::Message &message ) {
+		received.push_back( message.getAddressId() );
+	});
+	receiver.setListener( sFader, [&]( const osc::Message &message ) {
+		received.push_back( message.getAddressId() );
+	});
+	sender.send( osc::Message( "/mixer/1/fader", 1 ) );
+	receiver.dispatch( sender.getLastPacket() );
+	receiver.dispatch( sender.getLastPacket() );
+	OSC_CHECK( received.size() == 4 );
+	for( auto & id : received )
+		OSC_CHECK( id == fader );
+	
+	// an incoming pattern reaches the literal listener, but keeps its own address.
+	received.clear();
+	sender.send( osc::Message( "/mixer/?/fader", 1 ) );
+	receiver.dispatch( sender.getLastPacket() );
+	OSC_CHECK( received.size() == 1 );
+	OSC_CHECK( received[0] != fader && received[0].getAddress() == "/mixer/?/fader" );
+	
+	// removing the literal listener drops its id from the table, replacing it keeps it.
+	receiver.setListener( sFader, [&]( const osc::Message &message ) {
+		received.push_back( message.getAddressId() );
+	});
+	received.clear();
+	sender.send( osc::Message( "/mixer/1/fader", 1 ) );
+	receiver.dispatch( sender.getLastPacket() );
+	OSC_CHECK( received.size() == 2 && received[1] == fader );
+	receiver.removeListener( "/mixer/1/fader" );
+	received.clear();
+	receiver.dispatch( sender.getLastPacket() );
+	OSC_CHECK( received.size() == 1 && received[0] == fader );
+}
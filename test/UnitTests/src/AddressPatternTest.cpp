@@ -0,0 +1,79 @@
+#include "UnitTest.h"
+
+using namespace std;
+
+namespace {
+
+//! Exposes the compiled segment matcher and the matcher it replaces.
+class PatternReceiver : public test::LoopbackReceiver {
+public:
+	using LoopbackReceiver::SegmentMatcher;
+	using LoopbackReceiver::patternMatch;
+};
+
+using SegmentMatcher = PatternReceiver::SegmentMatcher;
+
+bool matches( const std::string &pattern, const std::string &segment )
+{
+	SegmentMatcher matcher( pattern );
+	OSC_CHECK( matcher.isCompiled() );
+	return matcher.match( segment.data(), segment.size() );
+}
+
+} // anonymous namespace
+
+OSC_TEST( compiledPatternsMatch )
+{
+	OSC_CHECK( matches( "abc", "abc" ) && ! matches( "abc", "abd" ) && ! matches( "abc", "ab" ) );
+	OSC_CHECK( matches( "a?c", "abc" ) && ! matches( "a?c", "ac" ) );
+	OSC_CHECK( matches( "*", "" ) && ! matches( "?", "" ) );
+	OSC_CHECK( matches( "a*c", "ac" ) && matches( "a*c", "abbbc" ) && ! matches( "a*c", "abcd" ) );
+	// '*' doesn't backtrack, so repeated stars stay linear.
+	OSC_CHECK( matches( "*a*a*a*a*b", std::string( 60, 'a' ) + "b" ) );
+	OSC_CHECK( ! matches( "*a*a*a*a*b", std::string( 60, 'a' ) ) );
+	OSC_CHECK( matches( "[ab]x", "bx" ) && ! matches( "[ab]x", "cx" ) );
+	OSC_CHECK( matches( "[!ab]x", "cx" ) && ! matches( "[!ab]x", "ax" ) );
+	OSC_CHECK( matches( "[0-9]", "5" ) && ! matches( "[0-9]", "a" ) );
+	// reversed ranges are accepted like the existing matcher does.
+	OSC_CHECK( matches( "[9-0]", "5" ) );
+	OSC_CHECK( matches( "{foo,bar}", "bar" ) && ! matches( "{foo,bar}", "baz" ) );
+	OSC_CHECK( matches( "x{,y}", "x" ) && matches( "x{,y}", "xy" ) );
+	OSC_CHECK( matches( "{b,ab,abc}c", "abcc" ) && matches( "{b,ab,abc}c", "abc" ) );
+	OSC_CHECK( matches( "ch*7{x,y}", "ch12347y" ) && ! matches( "ch*7{x,y}", "ch1234y" ) );
+}
+
+OSC_TEST( malformedPatternsMatchNothing )
+{
+	OSC_CHECK( ! matches( "[ab", "a" ) );
+	OSC_CHECK( ! matches( "{a,b", "a" ) );
+}
+
+OSC_TEST( oversizedPatternsFallBack )
+{
+	std::string pattern = std::string( SegmentMatcher::sMaxPositions + 6, 'a' ) + "*";
+	OSC_CHECK( ! SegmentMatcher( pattern ).isCompiled() );
+	
+	// dispatch matches them with patternMatch instead.
+	PatternReceiver receiver;
+	int numReceived = 0;
+	receiver.setListener( "/" + pattern, [&]( const osc::Message & ) {
+		++numReceived;
+	});
+	test::CaptureSender sender;
+	sender.send( osc::Message( "/" + pattern.substr( 0, pattern.size() - 1 ) + "tail", 1 ) );
+	receiver.dispatch( sender.getLastPacket() );
+	sender.send( osc::Message( "/" + std::string( 20, 'a' ), 1 ) );
+	receiver.dispatch( sender.getLastPacket() );
+	OSC_CHECK( numReceived == 1 );
+}
+
+OSC_TEST( compiledPatternsAgreeWithPatternMatch )
+{
+	// patternMatch handles these reliably, '*' and '{}' are covered by the benchmark's oracle.
+	PatternReceiver receiver;
+	const char *patterns[] = { "abc", "a?c", "[ab]c", "[!a]?", "[a-c]b", "?[!b-c]", "[cba][!c]a" };
+	const char *segments[] = { "", "a", "abc", "bbc", "cba", "acc", "ab", "ca", "ccc", "aaa" };
+	for( auto pattern : patterns )
+		for( auto segment : segments )
+			OSC_CHECK( matches( pattern, segment ) == receiver.patternMatch( segment, pattern ) );
+}
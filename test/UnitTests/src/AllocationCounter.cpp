@@ -0,0 +1,41 @@
+// Replaces the global operator new to count every allocation of the test program, so tests can
+// check that a path doesn't allocate. Kept on its own so nothing else is inlined with it.
+
+#include "UnitTest.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<size_t> sNumAllocations( 0 );
+
+} // anonymous namespace
+
+void* operator new( size_t size )
+{
+	++sNumAllocations;
+	if( void *ptr = malloc( size ? size : 1 ) )
+		return ptr;
+	throw std::bad_alloc();
+}
+
+void operator delete( void *ptr ) NOEXCEPT
+{
+	free( ptr );
+}
+
+void operator delete( void *ptr, size_t ) NOEXCEPT
+{
+	free( ptr );
+}
+
+namespace test {
+
+size_t getNumAllocations()
+{
+	return sNumAllocations.load();
+}
+
+} // namespace test
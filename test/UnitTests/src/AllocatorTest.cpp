@@ -0,0 +1,101 @@
+#include "UnitTest.h"
+
+#include <cstdlib>
+#include <type_traits>
+
+using namespace std;
+
+namespace {
+
+static_assert( std::is_same<osc::ByteBuffer, std::vector<uint8_t>>::value, "ByteBuffer stays a plain vector" );
+
+//! Draws from malloc and counts what's outstanding.
+class CountingResource : public osc::MemoryResource {
+public:
+	void* allocate( size_t bytes, size_t /*alignment*/ ) override
+	{
+		++mNumAllocations;
+		mNumBytes += bytes;
+		return malloc( bytes );
+	}
+	void deallocate( void *ptr, size_t bytes, size_t /*alignment*/ ) override
+	{
+		--mNumAllocations;
+		mNumBytes -= bytes;
+		free( ptr );
+	}
+	
+	size_t	mNumAllocations = 0, mNumBytes = 0;
+};
+
+} // anonymous namespace
+
+OSC_TEST( messagesAllocateFromTheirResource )
+{
+	CountingResource resource;
+	test::CaptureSender sender;
+	{
+		osc::Message message( &resource, "/resource" );
+		OSC_CHECK( message.getMemoryResource() == &resource );
+		for( int i = 0; i < 100; i++ )
+			message.append( i );
+		OSC_CHECK( resource.mNumAllocations > 0 );
+		sender.send( message );
+		
+		osc::Message expected( "/resource" );
+		for( int i = 0; i < 100; i++ )
+			expected.append( i );
+		sender.send( expected );
+		OSC_CHECK( sender.mPackets[0] == sender.mPackets[1] );
+	}
+	OSC_CHECK( resource.mNumAllocations == 0 && resource.mNumBytes == 0 );
+}
+
+OSC_TEST( bundlesAllocateFromTheirResource )
+{
+	CountingResource resource;
+	test::CaptureSender sender;
+	{
+		osc::Bundle bundle( &resource );
+		osc::Bundle heapBundle;
+		for( int i = 0; i < 10; i++ ) {
+			osc::Message message( "/element", i );
+			bundle.append( message );
+			heapBundle.append( message );
+		}
+		OSC_CHECK( resource.mNumAllocations > 0 );
+		sender.send( bundle );
+		sender.send( heapBundle );
+		OSC_CHECK( sender.mPackets[0] == sender.mPackets[1] );
+	}
+	OSC_CHECK( resource.mNumAllocations == 0 );
+}
+
+OSC_TEST( arenaReusesItsBlocksAfterReset )
+{
+	osc::MonotonicArena arena( 1024 );
+	auto first = arena.allocate( 24, 8 );
+	auto second = arena.allocate( 3, 1 );
+	auto aligned = arena.allocate( 16, 16 );
+	OSC_CHECK( first && second && aligned && first != second );
+	OSC_CHECK( reinterpret_cast<uintptr_t>( aligned ) % 16 == 0 );
+	// larger than a block still works.
+	OSC_CHECK( arena.allocate( 4096, 8 ) != nullptr );
+	
+	arena.reset();
+	auto numAllocations = test::getNumAllocations();
+	OSC_CHECK( arena.allocate( 24, 8 ) == first );
+	for( int i = 0; i < 20; i++ )
+		arena.allocate( 24, 8 );
+	OSC_CHECK( test::getNumAllocations() == numAllocations );
+}
+
+OSC_TEST( resourceByteBufferUsesItsResource )
+{
+	CountingResource resource;
+	{
+		osc::ResourceByteBuffer buffer( 100, 0, osc::ResourceAllocator<uint8_t>( &resource ) );
+		OSC_CHECK( resource.mNumBytes == 100 );
+	}
+	OSC_CHECK( resource.mNumBytes == 0 );
+}
@@ -0,0 +1,59 @@
+#include "UnitTest.h"
+
+using namespace std;
+
+OSC_TEST( bulkAppendsEncodeLikeSingleAppends )
+{
+	std::vector<float> floats = { 0.5f, -1.0f, 2.25f };
+	std::vector<int32_t> ints = { 7, -8 };
+	osc::Message bulk( "/bulk" );
+	bulk.appendFloats( floats.data(), floats.size() );
+	bulk.appendInts( ints.data(), ints.size() );
+	osc::Message single( "/bulk", 0.5f, -1.0f, 2.25f, 7, -8 );
+	
+	test::CaptureSender sender;
+	sender.send( bulk );
+	sender.send( single );
+	OSC_CHECK( sender.mPackets[0] == sender.mPackets[1] );
+}
+
+OSC_TEST( arraysRoundTrip )
+{
+	std::vector<float> floats( 512 );
+	for( int i = 0; i < 512; i++ )
+		floats[i] = i * 0.25f;
+	std::vector<int32_t> ints( 7 );
+	for( int i = 0; i < 7; i++ )
+		ints[i] = -i;
+	
+	test::CaptureSender sender;
+	test::LoopbackReceiver receiver;
+	int numReceived = 0;
+	receiver.setListener( "/array", [&]( const osc::Message &message ) {
+		++numReceived;
+		std::vector<float> receivedFloats( 600 );
+		OSC_CHECK( message.getFloats( 0, receivedFloats.data(), receivedFloats.size() ) == 512 );
+		receivedFloats.resize( 512 );
+		OSC_CHECK( receivedFloats == floats );
+		// an array takes up an index for each of its brackets.
+		OSC_CHECK( message.getArgType( 512 ) == osc::ArgType::ARRAY_BEGIN );
+		int32_t receivedInts[10];
+		OSC_CHECK( message.getInts( 512, receivedInts, 10 ) == 7 );
+		OSC_CHECK( std::equal( ints.begin(), ints.end(), receivedInts ) );
+		OSC_CHECK( message.getInts( 513, receivedInts, 3 ) == 3 && receivedInts[2] == -2 );
+		OSC_CHECK( message.getArgType( 520 ) == osc::ArgType::ARRAY_END );
+		OSC_CHECK( message.getInts( 521, receivedInts, 10 ) == 0 );
+		OSC_CHECK( message.getArgString( 523 ) == "end" );
+		OSC_CHECK_THROWS( message.getFloats( 523, receivedFloats.data(), 1 ), osc::ExcNonConvertible );
+		OSC_CHECK_THROWS( message.getFloats( 524, receivedFloats.data(), 1 ), osc::ExcIndexOutOfBounds );
+	});
+	
+	osc::Message message( "/array" );
+	message.appendFloats( floats.data(), floats.size() );
+	message.appendInts( ints.data(), ints.size(), true );
+	message.appendInts( nullptr, 0, true );
+	message.append( "end" );
+	sender.send( message );
+	receiver.dispatch( sender.getLastPacket() );
+	OSC_CHECK( numReceived == 1 );
+}
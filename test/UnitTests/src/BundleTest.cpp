@@ -0,0 +1,90 @@
+#include "UnitTest.h"
+
+using namespace std;
+
+namespace {
+
+void appendBigEndian( osc::ByteBuffer &buffer, uint64_t v, size_t size )
+{
+	for( size_t i = size; i > 0; --i )
+		buffer.push_back( uint8_t( v >> ( ( i - 1 ) * 8 ) ) );
+}
+
+//! Appends \a message to \a buffer as a bundle element, prefixed with its size.
+void appendElement( osc::ByteBuffer &buffer, const osc::Message &message )
+{
+	appendBigEndian( buffer, message.encodedSize(), 4 );
+	auto offset = buffer.size();
+	buffer.resize( offset + message.encodedSize() );
+	message.encodeInto( buffer.data() + offset, message.encodedSize() );
+}
+
+} // anonymous namespace
+
+OSC_TEST( bundleConcatenatesItsElements )
+{
+	osc::Message first( "/first", 1 );
+	osc::Message second( "/second", 2.0f, std::string( "text" ) );
+	osc::Bundle bundle;
+	bundle.setTimetag( 5 );
+	bundle.append( first );
+	bundle.append( second );
+	
+	osc::ByteBuffer expected( { '#', 'b', 'u', 'n', 'd', 'l', 'e', 0 } );
+	appendBigEndian( expected, 5, 8 );
+	appendElement( expected, first );
+	appendElement( expected, second );
+	
+	test::CaptureSender sender;
+	sender.send( bundle );
+	OSC_CHECK( sender.getLastPacket() == expected );
+	OSC_CHECK( bundle.size() == expected.size() + 4 );
+}
+
+OSC_TEST( bundleKeepsTheStateAtAppend )
+{
+	osc::Message message( "/value", 1 );
+	osc::Bundle bundle;
+	bundle.append( message );
+	message.setArg( 0, 2 );
+	bundle.append( message );
+	osc::Bundle nested;
+	nested.append( bundle );
+	bundle.clear();
+	OSC_CHECK( bundle.size() == 20 );
+	
+	test::CaptureSender sender;
+	test::LoopbackReceiver receiver;
+	std::vector<int> values;
+	receiver.setListener( "/value", [&]( const osc::Message &received ) {
+		values.push_back( received.getArgInt( 0 ) );
+	});
+	sender.send( nested );
+	receiver.dispatch( sender.getLastPacket() );
+	OSC_CHECK( values.size() == 2 && values[0] == 1 && values[1] == 2 );
+}
+
+OSC_TEST( largeBundlesArriveAsOneDatagram )
+{
+	// SenderUdp gathers more elements than fit a single gather call with sendmsg.
+	asio::io_service io;
+	asio::ip::udp::socket socket( io, asio::ip::udp::endpoint( asio::ip::address_v4::loopback(), 0 ) );
+	osc::SenderUdp sender( 0, "127.0.0.1", socket.local_endpoint().port(), asio::ip::udp::v4(), io );
+	sender.bind();
+	osc::Bundle bundle;
+	for( int i = 0; i < 300; i++ )
+		bundle.append( osc::Message( "/m", i ) );
+	sender.send( bundle );
+	io.poll();
+	
+	// loopback delivers right away, so don't block if the datagram got lost.
+	OSC_CHECK( socket.available() > 0 );
+	if( ! socket.available() )
+		return;
+	test::CaptureSender capture;
+	capture.send( bundle );
+	std::vector<uint8_t> received( 65536 );
+	size_t size = socket.receive( asio::buffer( received ) );
+	received.resize( size );
+	OSC_CHECK( received == capture.getLastPacket() );
+}
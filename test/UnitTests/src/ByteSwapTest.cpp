@@ -0,0 +1,87 @@
+#include "UnitTest.h"
+
+#include <cstring>
+
+using namespace std;
+
+namespace {
+
+//! Returns the big endian value of the \a size bytes at \a data.
+uint64_t readBigEndian( const uint8_t *data, size_t size )
+{
+	uint64_t v = 0;
+	for( size_t i = 0; i < size; i++ )
+		v = ( v << 8 ) | data[i];
+	return v;
+}
+
+uint32_t getBits( float v )
+{
+	uint32_t bits;
+	memcpy( &bits, &v, sizeof( bits ) );
+	return bits;
+}
+
+} // anonymous namespace
+
+OSC_TEST( runsOfEveryLengthAreBigEndian )
+{
+	// the swap kernel works in vector sized blocks, so cover the lengths around them.
+	for( int count = 1; count <= 40; count++ ) {
+		osc::Message message( "/v" );
+		for( int i = 0; i < count; i++ )
+			message.append( float( i ) * 1.5f );
+		for( int i = 0; i < count; i++ )
+			message.append( int64_t( i ) << 40 );
+		std::vector<uint8_t> packet( message.encodedSize() );
+		message.encodeInto( packet.data(), packet.size() );
+		
+		// the address "/v" takes 4 bytes and the type tag is padded to a multiple of 4.
+		auto data = packet.data() + 4 + ( ( 2 * count + 1 ) / 4 + 1 ) * 4;
+		for( int i = 0; i < count; i++ )
+			OSC_CHECK( readBigEndian( data + i * 4, 4 ) == getBits( float( i ) * 1.5f ) );
+		data += count * 4;
+		for( int i = 0; i < count; i++ )
+			OSC_CHECK( readBigEndian( data + i * 8, 8 ) == uint64_t( i ) << 40 );
+	}
+}
+
+OSC_TEST( mixedRunsRoundTrip )
+{
+	test::CaptureSender sender;
+	test::LoopbackReceiver receiver;
+	int numReceived = 0;
+	receiver.setListener( "/v", [&]( const osc::Message &message ) {
+		++numReceived;
+		for( int i = 0; i < 37; i++ )
+			OSC_CHECK( message[i].flt() == float( i ) * 1.5f );
+		OSC_CHECK( message[37].string() == "x" );
+		for( int i = 0; i < 11; i++ )
+			OSC_CHECK( message[38 + i].dbl() == double( i ) * -2.25 );
+		const void *blob;
+		size_t blobSize;
+		message[49].blobData( &blob, &blobSize );
+		OSC_CHECK( blobSize == 3 && ! memcmp( blob, "abc", 3 ) );
+		for( int i = 0; i < 9; i++ )
+			OSC_CHECK( message[50 + i].int64() == int64_t( i ) << 40 );
+		OSC_CHECK( message[59].int32() == -7 );
+		OSC_CHECK( message.getArgTime( 60 ) == 0x0102030405060708ULL );
+	});
+	
+	osc::Message message( "/v" );
+	for( int i = 0; i < 37; i++ )
+		message.append( float( i ) * 1.5f );
+	message.append( "x" );
+	for( int i = 0; i < 11; i++ )
+		message.append( double( i ) * -2.25 );
+	message.appendBlob( (void*)"abc", 3 );
+	for( int i = 0; i < 9; i++ )
+		message.append( int64_t( i ) << 40 );
+	message.append( -7 );
+	message.appendTimeTag( 0x0102030405060708ULL );
+	sender.send( message );
+	receiver.dispatch( sender.getLastPacket() );
+	// a second round decodes with the cached decode plan.
+	receiver.dispatch( sender.getLastPacket() );
+	OSC_CHECK( numReceived == 2 );
+}
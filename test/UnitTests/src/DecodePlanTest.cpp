@@ -0,0 +1,82 @@
+#include "UnitTest.h"
+
+using namespace std;
+
+OSC_TEST( plansAreCachedByTypeTag )
+{
+	test::CaptureSender sender;
+	test::LoopbackReceiver receiver;
+	// received messages are encoded again, to compare them with what was sent.
+	test::CaptureSender received;
+	receiver.setListener( "/plan", [&]( const osc::Message &message ) {
+		received.send( message );
+	});
+	OSC_CHECK( receiver.getDecodePlanCacheSize() == 0 && receiver.getDecodePlanHitRate() == 0.0 );
+	
+	// a fixed size tag, and one with a string and a blob whose offsets vary.
+	osc::Message fixed( "/plan", 1, 2.5f, int64_t( -3 ), 4.5, true );
+	osc::Message variable( "/plan", std::string( "text" ), 5, std::string( "longer text" ) );
+	variable.appendBlob( (void*)"abc", 3 );
+	variable.append( 6.5f );
+	for( int i = 0; i < 3; i++ ) {
+		sender.send( fixed );
+		receiver.dispatch( sender.getLastPacket() );
+		sender.send( variable );
+		receiver.dispatch( sender.getLastPacket() );
+	}
+	OSC_CHECK( receiver.getDecodePlanCacheSize() == 2 );
+	OSC_CHECK( receiver.getDecodePlanHitRate() == 4.0 / 6.0 );
+	// messages decoded with a cached plan match those decoded without one.
+	OSC_CHECK( received.mPackets.size() == 6 );
+	for( size_t i = 0; i < received.mPackets.size(); i++ )
+		OSC_CHECK( received.mPackets[i] == sender.mPackets[i] );
+}
+
+OSC_TEST( plansStillCheckTheBounds )
+{
+	test::CaptureSender sender;
+	test::LoopbackReceiver receiver;
+	int numReceived = 0;
+	receiver.setListener( "/plan", [&]( const osc::Message &message ) {
+		++numReceived;
+		OSC_CHECK( message.getArgInt( 1 ) == 2 );
+	});
+	sender.send( osc::Message( "/plan", 1, 2 ) );
+	receiver.dispatch( sender.getLastPacket() );
+	OSC_CHECK( receiver.getDecodePlanCacheSize() == 1 );
+	
+	// the same tag cut short is rejected, while trailing bytes are ignored as without a plan.
+	auto truncated = sender.getLastPacket();
+	truncated.resize( truncated.size() - 4 );
+	receiver.dispatch( truncated );
+	OSC_CHECK( numReceived == 1 );
+	auto extended = sender.getLastPacket();
+	extended.resize( extended.size() + 4 );
+	receiver.dispatch( extended );
+	OSC_CHECK( numReceived == 2 );
+}
+
+OSC_TEST( tagsBeyondTheCacheStillDecode )
+{
+	test::CaptureSender sender;
+	test::LoopbackReceiver receiver;
+	int numReceived = 0;
+	int expectedNumArgs = 0;
+	receiver.setListener( "/plan", [&]( const osc::Message &message ) {
+		++numReceived;
+		OSC_CHECK( message.getArgInt( expectedNumArgs - 1 ) == expectedNumArgs );
+		OSC_CHECK_THROWS( message.getArgInt( expectedNumArgs ), osc::ExcIndexOutOfBounds );
+	});
+	// every amount of ints is its own type tag.
+	for( int round = 0; round < 2; round++ ) {
+		osc::Message message( "/plan" );
+		for( int i = 1; i <= 80; i++ ) {
+			message.append( i );
+			expectedNumArgs = i;
+			sender.send( message );
+			receiver.dispatch( sender.getLastPacket() );
+		}
+	}
+	OSC_CHECK( numReceived == 160 );
+	OSC_CHECK( receiver.getDecodePlanCacheSize() == 64 );
+}
@@ -0,0 +1,88 @@
+#include "UnitTest.h"
+
+#include <cstdlib>
+#include <cstring>
+
+using namespace std;
+
+namespace {
+
+//! Draws from malloc and counts the allocations.
+class CountingResource : public osc::MemoryResource {
+public:
+	void* allocate( size_t bytes, size_t /*alignment*/ ) override
+	{
+		++mNumAllocations;
+		return malloc( bytes );
+	}
+	void deallocate( void *ptr, size_t /*bytes*/, size_t /*alignment*/ ) override
+	{
+		free( ptr );
+	}
+	
+	size_t	mNumAllocations = 0;
+};
+
+//! Encodes a bundle of \a count same shaped messages, whose values depend on \a round.
+osc::ByteBuffer makePacket( int round, int count = 4, const std::string &text = "text" )
+{
+	osc::Bundle bundle;
+	for( int i = 0; i < count; i++ )
+		bundle.append( osc::Message( "/scratch/" + std::to_string( i ), round, float( i ), text ) );
+	test::CaptureSender sender;
+	sender.send( bundle );
+	return sender.getLastPacket();
+}
+
+} // anonymous namespace
+
+OSC_TEST( steadyDispatchDoesntAllocate )
+{
+	test::LoopbackReceiver receiver;
+	int numReceived = 0, sum = 0;
+	receiver.setListener( "/scratch/*", [&]( const osc::Message &message ) {
+		++numReceived;
+		sum += message.getArgInt( 0 );
+		OSC_CHECK( message.getArgString( 2 ) == "text" );
+	});
+	
+	std::vector<osc::ByteBuffer> packets;
+	for( int round = 0; round < 50; round++ )
+		packets.push_back( makePacket( round ) );
+	// the decoder swaps in place, so every round dispatches a fresh copy.
+	osc::ByteBuffer packet( packets[0].size() );
+	auto dispatch = [&]( int round ) {
+		memcpy( packet.data(), packets[round].data(), packet.size() );
+		receiver.dispatch( packet.data(), packet.size() );
+	};
+	dispatch( 0 );
+	dispatch( 1 );
+	
+	auto numAllocations = test::getNumAllocations();
+	for( int round = 2; round < 50; round++ )
+		dispatch( round );
+	OSC_CHECK( test::getNumAllocations() == numAllocations );
+	OSC_CHECK( numReceived == 200 && sum == 4 * 49 * 50 / 2 );
+}
+
+OSC_TEST( decodeArenaBacksTheScratch )
+{
+	CountingResource resource;
+	test::LoopbackReceiver receiver;
+	receiver.setDecodeArena( &resource );
+	std::vector<int> values;
+	receiver.setListener( "/scratch/*", [&]( const osc::Message &message ) {
+		OSC_CHECK( message.getMemoryResource() == &resource );
+		values.push_back( message.getArgInt( 0 ) );
+	});
+	
+	// more messages than views fit inline, with arguments that don't fit a message inline.
+	std::string text( 300, 'a' );
+	receiver.dispatch( makePacket( 1, 20, text ) );
+	OSC_CHECK( resource.mNumAllocations > 0 );
+	// once warmed up, the scratch keeps its capacity.
+	auto numAllocations = resource.mNumAllocations;
+	receiver.dispatch( makePacket( 2, 20, text ) );
+	OSC_CHECK( resource.mNumAllocations == numAllocations );
+	OSC_CHECK( values.size() == 40 && values[0] == 1 && values[39] == 2 );
+}
@@ -0,0 +1,63 @@
+#include "UnitTest.h"
+
+using namespace std;
+
+OSC_TEST( stringsOfEveryLengthDecode )
+{
+	// the scans work in vector sized blocks, so cover the lengths and alignments around them.
+	test::CaptureSender sender;
+	test::LoopbackReceiver receiver;
+	int numReceived = 0;
+	std::string expectedAddress, expectedText;
+	receiver.setListener( "/*", [&]( const osc::Message &message ) {
+		++numReceived;
+		OSC_CHECK( message.getAddress() == expectedAddress );
+		OSC_CHECK( message.getArgString( 0 ) == expectedText );
+		OSC_CHECK( message.getArgInt( 1 ) == 7 );
+		OSC_CHECK( message.getArgString( 2 ) == expectedAddress );
+	});
+	int numSent = 0;
+	for( size_t addressLength = 1; addressLength < 70; addressLength += 3 ) {
+		for( size_t textLength = 0; textLength < 70; textLength++ ) {
+			expectedAddress = "/" + std::string( addressLength, 'a' );
+			expectedText = std::string( textLength, 'b' );
+			sender.send( osc::Message( expectedAddress, expectedText, 7, expectedAddress ) );
+			auto &packet = sender.getLastPacket();
+			
+			osc::MessageView view( packet.data(), packet.size() );
+			OSC_CHECK( view.isValid() && view.getNumArgs() == 3 );
+			OSC_CHECK( view.getArgString( 0 ) == expectedText );
+			receiver.dispatch( packet );
+			++numSent;
+		}
+	}
+	OSC_CHECK( numReceived == numSent );
+}
+
+OSC_TEST( unterminatedStringsAreRejected )
+{
+	test::LoopbackReceiver receiver;
+	int numReceived = 0, numViews = 0;
+	receiver.setListener( "/s", [&]( const osc::Message & ) {
+		++numReceived;
+	});
+	// views check their arguments as they're read.
+	receiver.setViewListener( "/s", [&]( const osc::MessageView &view ) {
+		++numViews;
+		OSC_CHECK_THROWS( view.getArgString( 0 ), osc::ExcIndexOutOfBounds );
+	});
+	
+	// a string argument that runs up to the end of the packet, for every length around a block.
+	for( size_t length = 4; length <= 64; length += 4 ) {
+		osc::ByteBuffer packet( { '/', 's', 0, 0, ',', 's', 0, 0 } );
+		packet.resize( packet.size() + length, 'x' );
+		receiver.dispatch( packet );
+	}
+	OSC_CHECK( numViews == 16 );
+	// and an address without its terminator.
+	osc::ByteBuffer address( 40, 'a' );
+	address[0] = '/';
+	OSC_CHECK( ! osc::MessageView( address.data(), address.size() ).isValid() );
+	receiver.dispatch( address );
+	OSC_CHECK( numReceived == 0 && numViews == 16 );
+}
@@ -0,0 +1,100 @@
+#include "UnitTest.h"
+
+#include <atomic>
+#include <map>
+#include <thread>
+
+using namespace std;
+
+namespace {
+
+using Execution = osc::ReceiverBase::Execution;
+
+osc::ByteBuffer makePacket( const std::string &address, int value )
+{
+	test::CaptureSender sender;
+	sender.send( osc::Message( address, value ) );
+	return sender.getLastPacket();
+}
+
+} // anonymous namespace
+
+OSC_TEST( poolListenersRunInlineWithoutAPool )
+{
+	test::LoopbackReceiver receiver;
+	bool ranInline = false;
+	auto thread = std::this_thread::get_id();
+	receiver.setListener( "/pool", [&]( const osc::Message & ) {
+		ranInline = std::this_thread::get_id() == thread;
+	}, Execution::POOL );
+	receiver.dispatch( makePacket( "/pool", 0 ) );
+	OSC_CHECK( ranInline );
+}
+
+OSC_TEST( poolKeepsTheOrderOfEachAddress )
+{
+	std::mutex seenMutex;
+	std::map<std::string, std::vector<int>> seen;
+	std::atomic<int> numDone( 0 ), numBusy( 0 ), maxBusy( 0 );
+	// declared after what the listeners use, so that its pool stops first.
+	test::LoopbackReceiver receiver;
+	receiver.setDispatchPool( std::make_shared<osc::DispatchPool>( 4 ) );
+	auto listener = [&]( const osc::Message &message ) {
+		int busy = ++numBusy;
+		int max = maxBusy;
+		while( busy > max && ! maxBusy.compare_exchange_weak( max, busy ) ) {}
+		std::this_thread::sleep_for( std::chrono::microseconds( 200 ) );
+		{
+			std::lock_guard<std::mutex> lock( seenMutex );
+			seen[message.getAddress()].push_back( message.getArgInt( 0 ) );
+		}
+		--numBusy;
+		++numDone;
+	};
+	const char *addresses[] = { "/v/a", "/v/b", "/v/c", "/v/d", "/v/e", "/v/f" };
+	for( auto address : addresses )
+		receiver.setListener( address, listener, Execution::POOL );
+	for( int i = 0; i < 100; i++ )
+		for( auto address : addresses )
+			receiver.dispatch( makePacket( address, i ) );
+	
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds( 10 );
+	while( numDone < 600 && std::chrono::steady_clock::now() < deadline )
+		std::this_thread::yield();
+	OSC_CHECK( numDone == 600 );
+	std::lock_guard<std::mutex> lock( seenMutex );
+	OSC_CHECK( seen.size() == 6 );
+	for( auto & values : seen ) {
+		OSC_CHECK( values.second.size() == 100 );
+		for( size_t i = 0; i < values.second.size(); i++ )
+			OSC_CHECK( values.second[i] == int( i ) );
+	}
+	// different addresses run in parallel.
+	OSC_CHECK( maxBusy > 1 );
+}
+
+OSC_TEST( executorsRunTheirListeners )
+{
+	test::LoopbackReceiver receiver;
+	std::vector<std::function<void()>> tasks;
+	int sum = 0;
+	receiver.setListener( "/executor", [&]( const osc::Message &message ) {
+		sum += message.getArgInt( 0 );
+	}, [&]( std::function<void()> task ) {
+		tasks.push_back( task );
+	});
+	// the decoded message outlives the dispatch, until the executor runs the task.
+	receiver.dispatch( makePacket( "/executor", 5 ) );
+	receiver.dispatch( makePacket( "/executor", 6 ) );
+	OSC_CHECK( sum == 0 && tasks.size() == 2 );
+	for( auto & task : tasks )
+		task();
+	OSC_CHECK( sum == 11 );
+	
+	// replaced by an inline listener, the executor isn't used anymore.
+	receiver.setListener( "/executor", [&]( const osc::Message & ) {
+		sum = -1;
+	});
+	receiver.dispatch( makePacket( "/executor", 1 ) );
+	OSC_CHECK( sum == -1 && tasks.size() == 2 );
+}
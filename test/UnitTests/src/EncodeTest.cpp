@@ -0,0 +1,84 @@
+#include "UnitTest.h"
+
+#include <cstring>
+
+using namespace std;
+
+namespace {
+
+osc::Message makeEveryArgType()
+{
+	osc::Message message( "/app/1" );
+	message.append( 42 );
+	message.append( std::string( "hello" ) );
+	message.append( 1.5f );
+	message.append( 2.25 );
+	message.append( int64_t( 1000000000000LL ) );
+	message.append( 'X' );
+	message.append( true );
+	message.appendMidi( 1, 2, 3, 4 );
+	message.appendBlob( (void*)"abcde", 5 );
+	message.appendTimeTag( 5 );
+	return message;
+}
+
+} // anonymous namespace
+
+OSC_TEST( encodeIntoMatchesTheSentPacket )
+{
+	test::CaptureSender sender;
+	auto message = makeEveryArgType();
+	sender.send( message );
+	auto &sent = sender.getLastPacket();
+	OSC_CHECK( message.encodedSize() == sent.size() );
+	OSC_CHECK( message.size() == sent.size() + 4 );
+	
+	std::vector<uint8_t> buffer( message.encodedSize() );
+	OSC_CHECK( message.encodeInto( buffer.data(), buffer.size() ) == buffer.size() );
+	OSC_CHECK( buffer == sent );
+}
+
+OSC_TEST( encodeIntoRefusesSmallBuffers )
+{
+	osc::Message message( "/mousemove/1", 1, 2, 3 );
+	OSC_CHECK( message.encodedSize() == 16 + 8 + 12 );
+	uint8_t buffer[64];
+	memset( buffer, 0xAB, sizeof( buffer ) );
+	OSC_CHECK( message.encodeInto( buffer, message.encodedSize() - 1 ) == 0 );
+	OSC_CHECK( buffer[0] == 0xAB );
+	OSC_CHECK( message.encodeInto( buffer, sizeof( buffer ) ) == message.encodedSize() );
+}
+
+OSC_TEST( encodedMessagesDecodeToTheSameArguments )
+{
+	test::CaptureSender sender;
+	test::LoopbackReceiver receiver;
+	int numReceived = 0;
+	receiver.setListener( "/app/*", [&]( const osc::Message &message ) {
+		++numReceived;
+		OSC_CHECK( message[0].int32() == 42 );
+		OSC_CHECK( message[1].string() == "hello" );
+		OSC_CHECK( message[2].flt() == 1.5f );
+		OSC_CHECK( message[3].dbl() == 2.25 );
+		OSC_CHECK( message[4].int64() == 1000000000000LL );
+		OSC_CHECK( message[5].character() == 'X' );
+		OSC_CHECK( message[6].boolean() );
+		uint8_t port, status, data1, data2;
+		message[7].midi( &port, &status, &data1, &data2 );
+		OSC_CHECK( port == 1 && status == 2 && data1 == 3 && data2 == 4 );
+		const void *blob;
+		size_t blobSize;
+		message[8].blobData( &blob, &blobSize );
+		OSC_CHECK( blobSize == 5 && ! memcmp( blob, "abcde", 5 ) );
+		OSC_CHECK( message.getArgTime( 9 ) == 5 );
+	});
+	auto message = makeEveryArgType();
+	sender.send( message );
+	receiver.dispatch( sender.getLastPacket() );
+	OSC_CHECK( numReceived == 1 );
+	
+	std::vector<uint8_t> buffer( message.encodedSize() );
+	message.encodeInto( buffer.data(), buffer.size() );
+	receiver.dispatch( buffer );
+	OSC_CHECK( numReceived == 2 );
+}
@@ -0,0 +1,116 @@
+#include "UnitTest.h"
+
+#include <atomic>
+#include <thread>
+
+using namespace std;
+
+namespace {
+
+osc::ByteBuffer makePacket( const std::string &address )
+{
+	test::CaptureSender sender;
+	sender.send( osc::Message( address, 1 ) );
+	return sender.getLastPacket();
+}
+
+} // anonymous namespace
+
+OSC_TEST( listenersCanChangeListeners )
+{
+	// a listener registering another one used to deadlock on the listener mutex.
+	test::LoopbackReceiver receiver;
+	int numInner = 0;
+	receiver.setListener( "/register", [&]( const osc::Message & ) {
+		receiver.setListener( "/inner", [&]( const osc::Message & ) {
+			++numInner;
+		});
+		receiver.removeListener( "/nothing" );
+	});
+	receiver.dispatch( makePacket( "/register" ) );
+	receiver.dispatch( makePacket( "/inner" ) );
+	OSC_CHECK( numInner == 1 );
+	
+	// a listener removing itself finishes its call.
+	int numRemoved = 0;
+	receiver.setListener( "/once", [&]( const osc::Message & ) {
+		receiver.removeListener( "/once" );
+		++numRemoved;
+	});
+	receiver.dispatch( makePacket( "/once" ) );
+	receiver.dispatch( makePacket( "/once" ) );
+	OSC_CHECK( numRemoved == 1 );
+}
+
+OSC_TEST( listenersChangeWhileDispatching )
+{
+	test::LoopbackReceiver receiver;
+	osc::ReceiverBase::Listeners listeners;
+	std::atomic<int> numReceived( 0 );
+	for( int i = 0; i < 3000; i++ ) {
+		listeners.push_back( { "/m/" + std::to_string( i ), [&]( const osc::Message & ) {
+			++numReceived;
+		} } );
+	}
+	receiver.setListeners( listeners );
+	receiver.dispatch( makePacket( "/m/2999" ) );
+	OSC_CHECK( numReceived == 1 );
+	
+	// the dispatching thread reads a snapshot of the table, which this thread replaces.
+	std::atomic<bool> stop( false );
+	auto packet = makePacket( "/m/5" );
+	std::thread dispatcher( [&] {
+		while( ! stop )
+			receiver.dispatch( packet );
+	});
+	for( int i = 0; i < 300; i++ ) {
+		receiver.setListener( "/x/" + std::to_string( i ), []( const osc::Message & ) {} );
+		if( i % 3 == 0 )
+			receiver.removeListener( "/x/" + std::to_string( i - 1 ) );
+	}
+	stop = true;
+	dispatcher.join();
+	OSC_CHECK( numReceived > 1 );
+}
+
+OSC_TEST( tcpConnectionsDispatchConcurrently )
+{
+	uint16_t port;
+	{
+		asio::io_service io;
+		asio::ip::tcp::acceptor acceptor( io, asio::ip::tcp::endpoint( asio::ip::address_v4::loopback(), 0 ) );
+		port = acceptor.local_endpoint().port();
+	}
+	asio::io_service io;
+	osc::ReceiverTcp receiver( port, asio::ip::tcp::v4(), io );
+	std::atomic<int> sum( 0 );
+	receiver.setListener( "/t", [&]( const osc::Message &message ) {
+		sum += message.getArgInt( 0 );
+	});
+	receiver.bind();
+	receiver.listen();
+	
+	asio::ip::tcp::endpoint destination( asio::ip::address_v4::loopback(), port );
+	osc::SenderTcp first( 0, destination, asio::ip::tcp::v4(), io ), second( 0, destination, asio::ip::tcp::v4(), io );
+	first.bind();
+	second.bind();
+	first.connect();
+	second.connect();
+	for( int i = 0; i < 50; i++ ) {
+		first.send( osc::Message( "/t", 1 ) );
+		second.send( osc::Message( "/t", 2 ) );
+	}
+	// both threads run the connections' handlers.
+	auto run = [&] {
+		test::pollUntil( io, [&] { return sum == 150; } );
+	};
+	std::thread worker( run );
+	run();
+	worker.join();
+	OSC_CHECK( sum == 150 );
+	// each connection decodes into its own scratch.
+	OSC_CHECK( receiver.getDecodePlanCacheSize() == 2 );
+	first.close();
+	second.close();
+	receiver.close();
+}
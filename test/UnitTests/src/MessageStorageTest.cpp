@@ -0,0 +1,79 @@
+#include "UnitTest.h"
+
+using namespace std;
+
+OSC_TEST( smallVectorSpillsPastItsInlineCapacity )
+{
+	osc::SmallVector<std::string, 4> strings;
+	for( int i = 0; i < 4; i++ )
+		strings.emplace_back( std::to_string( i ) );
+	OSC_CHECK( strings.isInline() && strings.size() == 4 );
+	strings.emplace_back( "4" );
+	OSC_CHECK( ! strings.isInline() && strings.capacity() >= 5 );
+	for( int i = 0; i < 5; i++ )
+		OSC_CHECK( strings[i] == std::to_string( i ) );
+	
+	auto moved = std::move( strings );
+	OSC_CHECK( moved.size() == 5 && moved.back() == "4" );
+	OSC_CHECK( strings.empty() );
+}
+
+OSC_TEST( typicalMessagesDontAllocate )
+{
+	auto numAllocations = test::getNumAllocations();
+	{
+		osc::Message message( "/mix/ch", 1, 2.0f );
+		message.append( "hello" );
+		message.append( "abcdef", 3 );
+		OSC_CHECK( message.getArgString( 2 ) == "hello" && message.getArgString( 3 ) == "abc" );
+		OSC_CHECK( message.getArgType( 2 ) == osc::ArgType::STRING );
+		message.clear();
+		message.append( 3 );
+		OSC_CHECK( message.getArgInt( 0 ) == 3 );
+	}
+	OSC_CHECK( test::getNumAllocations() == numAllocations );
+	
+	std::vector<int> counted( 1 );
+	OSC_CHECK( test::getNumAllocations() > numAllocations );
+}
+
+OSC_TEST( largeMessagesSpillAndRoundTrip )
+{
+	test::CaptureSender sender;
+	test::LoopbackReceiver receiver;
+	int numReceived = 0;
+	receiver.setListener( "/big", [&]( const osc::Message &message ) {
+		++numReceived;
+		for( int i = 0; i < 40; i++ )
+			OSC_CHECK( message[i].int32() == i );
+		OSC_CHECK( message[40].string() == "literal" && message[41].string() == "abc" );
+	});
+	
+	osc::Message big( "/big" );
+	for( int i = 0; i < 40; i++ )
+		big.append( i );
+	big.append( "literal" );
+	big.append( std::string( "abc" ) );
+	osc::Message moved( std::move( big ) );
+	sender.send( moved );
+	receiver.dispatch( sender.getLastPacket() );
+	
+	osc::Message assigned( "/small", 1 );
+	assigned = std::move( moved );
+	sender.send( assigned );
+	receiver.dispatch( sender.getLastPacket() );
+	OSC_CHECK( numReceived == 2 );
+}
+
+OSC_TEST( reserveKeepsTheArguments )
+{
+	osc::Message message( "/a", 1, std::string( "s" ) );
+	message.reserve( 1000, 100 );
+	OSC_CHECK( message.getArgInt( 0 ) == 1 && message.getArgString( 1 ) == "s" );
+	
+	std::vector<osc::Message> messages;
+	for( int i = 0; i < 10; i++ )
+		messages.emplace_back( "/x", i, std::string( "s" ) );
+	for( int i = 0; i < 10; i++ )
+		OSC_CHECK( messages[i].getArgInt( 0 ) == i && messages[i][1].string() == "s" );
+}
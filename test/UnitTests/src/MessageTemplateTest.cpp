@@ -0,0 +1,90 @@
+#include "UnitTest.h"
+
+using namespace std;
+
+namespace {
+
+osc::Message makePrototype()
+{
+	osc::Message prototype( "/fixture/1", 0, 0.0f, 0.0, int64_t( 0 ), 'a', false );
+	prototype.appendMidi( 0, 0, 0, 0 );
+	prototype.append( std::string( "const" ) );
+	prototype.appendTimeTag( 0 );
+	return prototype;
+}
+
+} // anonymous namespace
+
+OSC_TEST( templateStartsAsItsPrototype )
+{
+	test::CaptureSender sender;
+	auto prototype = makePrototype();
+	osc::MessageTemplate messageTemplate( prototype );
+	OSC_CHECK( messageTemplate.getAddress() == "/fixture/1" );
+	OSC_CHECK( messageTemplate.getNumArgs() == 9 );
+	OSC_CHECK( messageTemplate.getArgType( 1 ) == osc::ArgType::FLOAT );
+	OSC_CHECK( messageTemplate.size() == prototype.size() );
+	
+	sender.send( prototype );
+	sender.send( messageTemplate );
+	OSC_CHECK( sender.mPackets[0] == sender.mPackets[1] );
+}
+
+OSC_TEST( templatePatchesEncodeLikeAFreshMessage )
+{
+	test::CaptureSender sender;
+	osc::MessageTemplate messageTemplate( makePrototype() );
+	messageTemplate.set( 0, 7 );
+	messageTemplate.set( 1, 2.5f );
+	messageTemplate.set( 2, 9.75 );
+	messageTemplate.set( 3, int64_t( -5 ) );
+	messageTemplate.set( 4, 'z' );
+	messageTemplate.set( 5, true );
+	messageTemplate.setMidi( 6, 9, 8, 7, 6 );
+	messageTemplate.setTimeTag( 8, 77 );
+	sender.send( messageTemplate );
+	
+	osc::Message expected( "/fixture/1", 7, 2.5f, 9.75, int64_t( -5 ), 'z', true );
+	expected.appendMidi( 9, 8, 7, 6 );
+	expected.append( std::string( "const" ) );
+	expected.appendTimeTag( 77 );
+	sender.send( expected );
+	OSC_CHECK( sender.mPackets[0] == sender.mPackets[1] );
+	
+	test::LoopbackReceiver receiver;
+	int numReceived = 0;
+	receiver.setListener( "/fixture/1", [&]( const osc::Message &message ) {
+		++numReceived;
+		OSC_CHECK( message.getArgInt( 0 ) == 7 && message.getArgBool( 5 ) && message.getArgString( 7 ) == "const" );
+	});
+	receiver.dispatch( sender.mPackets[0] );
+	OSC_CHECK( numReceived == 1 );
+}
+
+OSC_TEST( templateKeepsSentPacketsIntact )
+{
+	test::CaptureSender sender;
+	osc::MessageTemplate messageTemplate( makePrototype() );
+	osc::Bundle bundle;
+	messageTemplate.set( 0, 1 );
+	bundle.append( messageTemplate );
+	messageTemplate.set( 0, 2 );
+	bundle.append( messageTemplate );
+	
+	test::LoopbackReceiver receiver;
+	std::vector<int> values;
+	receiver.setListener( "/fixture/1", [&]( const osc::Message &message ) {
+		values.push_back( message.getArgInt( 0 ) );
+	});
+	sender.send( bundle );
+	receiver.dispatch( sender.getLastPacket() );
+	OSC_CHECK( values.size() == 2 && values[0] == 1 && values[1] == 2 );
+}
+
+OSC_TEST( templateRejectsWrongSlots )
+{
+	osc::MessageTemplate messageTemplate( makePrototype() );
+	OSC_CHECK_THROWS( messageTemplate.set( 0, 1.0f ), osc::ExcNonConvertible );
+	OSC_CHECK_THROWS( messageTemplate.set( 7, 1 ), osc::ExcNonConvertible );
+	OSC_CHECK_THROWS( messageTemplate.set( 9, 1.0f ), osc::ExcIndexOutOfBounds );
+}
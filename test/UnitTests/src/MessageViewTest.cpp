@@ -0,0 +1,104 @@
+#include "UnitTest.h"
+
+#include <cstring>
+
+using namespace std;
+
+namespace {
+
+osc::Message makeMessage()
+{
+	osc::Message message( "/view/test" );
+	message.append( int32_t( -7 ) );
+	message.append( 2.5f );
+	message.append( std::string( "hello" ) );
+	message.append( int64_t( 1234567890123LL ) );
+	message.append( 3.25 );
+	message.append( true );
+	message.append( 'x' );
+	message.appendMidi( 1, 2, 3, 4 );
+	message.appendBlob( (void*)"abcde", 5 );
+	message.append( false );
+	return message;
+}
+
+} // anonymous namespace
+
+OSC_TEST( viewReadsEveryArgType )
+{
+	test::CaptureSender sender;
+	sender.send( makeMessage() );
+	auto &packet = sender.getLastPacket();
+	osc::MessageView view( packet.data(), packet.size() );
+	OSC_CHECK( view.isValid() );
+	OSC_CHECK( std::string( view.getAddress() ) == "/view/test" && view.getAddressLength() == 10 );
+	OSC_CHECK( view.getNumArgs() == 10 );
+	OSC_CHECK( view.getArgType( 2 ) == osc::ArgType::STRING );
+	// arguments can be read in any order.
+	OSC_CHECK( view.getArgFloat( 1 ) == 2.5f );
+	OSC_CHECK( view.getArgInt( 0 ) == -7 );
+	OSC_CHECK( std::string( view.getArgString( 2 ) ) == "hello" );
+	OSC_CHECK( view.getArgInt64( 3 ) == 1234567890123LL );
+	OSC_CHECK( view.getArgDouble( 4 ) == 3.25 );
+	OSC_CHECK( view.getArgBool( 5 ) );
+	OSC_CHECK( view.getArgChar( 6 ) == 'x' );
+	uint8_t port, status, data1, data2;
+	view.getArgMidi( 7, &port, &status, &data1, &data2 );
+	OSC_CHECK( port == 1 && status == 2 && data1 == 3 && data2 == 4 );
+	const void *blob;
+	size_t blobSize;
+	view.getArgBlobData( 8, &blob, &blobSize );
+	OSC_CHECK( blobSize == 5 && ! memcmp( blob, "abcde", 5 ) );
+	OSC_CHECK( ! view.getArgBool( 9 ) );
+	OSC_CHECK_THROWS( view.getArgInt( 1 ), osc::ExcNonConvertible );
+	OSC_CHECK_THROWS( view.getArgInt( 10 ), osc::ExcIndexOutOfBounds );
+}
+
+OSC_TEST( viewNeverReadsPastItsBytes )
+{
+	test::CaptureSender sender;
+	sender.send( makeMessage() );
+	auto packet = sender.getLastPacket();
+	// cut into the blob, which starts 20 bytes from the end.
+	packet.resize( packet.size() - 12 );
+	osc::MessageView truncated( packet.data(), packet.size() );
+	OSC_CHECK( truncated.isValid() );
+	OSC_CHECK( truncated.getArgInt( 0 ) == -7 );
+	OSC_CHECK_THROWS( truncated.getArgBlobData( 8, nullptr, nullptr ), osc::ExcIndexOutOfBounds );
+	
+	uint8_t noTypeTag[] = { '/', 'a', 'b', 'c' };
+	OSC_CHECK( ! osc::MessageView( noTypeTag, sizeof( noTypeTag ) ).isValid() );
+}
+
+OSC_TEST( viewListenersRunAlongsideMessageListeners )
+{
+	test::CaptureSender sender;
+	test::LoopbackReceiver receiver;
+	int numViews = 0, numMessages = 0;
+	receiver.setViewListener( "/view/*", [&]( const osc::MessageView &view ) {
+		++numViews;
+		if( std::string( view.getAddress() ) == "/view/b" )
+			OSC_CHECK( view.getArgInt( 0 ) == 9 );
+		else
+			OSC_CHECK( std::string( view.getArgString( 2 ) ) == "hello" );
+	});
+	receiver.setListener( "/view/test", [&]( const osc::Message &message ) {
+		++numMessages;
+		OSC_CHECK( message.getArgString( 2 ) == "hello" );
+	});
+	auto message = makeMessage();
+	sender.send( message );
+	receiver.dispatch( sender.getLastPacket() );
+	OSC_CHECK( numViews == 1 && numMessages == 1 );
+	
+	receiver.removeListener( "/view/test" );
+	receiver.dispatch( sender.getLastPacket() );
+	OSC_CHECK( numViews == 2 && numMessages == 1 );
+	
+	osc::Bundle bundle;
+	bundle.append( osc::Message( "/view/b", 9 ) );
+	bundle.append( message );
+	sender.send( bundle );
+	receiver.dispatch( sender.getLastPacket() );
+	OSC_CHECK( numViews == 4 );
+}
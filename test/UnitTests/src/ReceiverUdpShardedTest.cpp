@@ -0,0 +1,127 @@
+#include "UnitTest.h"
+
+#include <atomic>
+#include <set>
+#include <thread>
+
+using namespace std;
+
+namespace {
+
+//! Returns a port that is free on the loopback interface, as the shards all need to bind the same one.
+uint16_t getFreePort()
+{
+	asio::io_service io;
+	asio::ip::udp::socket socket( io, asio::ip::udp::endpoint( asio::ip::address_v4::loopback(), 0 ) );
+	return socket.local_endpoint().port();
+}
+
+//! Waits until \a done returns true or two seconds have passed, while the shards dispatch on
+//! their own threads.
+template<typename DoneFn>
+bool waitUntil( const DoneFn &done )
+{
+	for( int i = 0; i < 200 && ! done(); i++ )
+		std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+	return done();
+}
+
+//! Expects closing to be the only error of \a receiver's sockets.
+void expectOnlyAbortedReceives( osc::ReceiverUdpSharded &receiver )
+{
+	receiver.setSocketErrorFn( []( const asio::error_code &error, const asio::ip::udp::endpoint & ) {
+		OSC_CHECK( error == asio::error::operation_aborted );
+	});
+}
+
+} // anonymous namespace
+
+OSC_TEST( shardsShareTheListeners )
+{
+	auto port = getFreePort();
+	osc::ReceiverUdpSharded receiver( port, 4 );
+	OSC_CHECK( receiver.getNumShards() == 4 );
+	expectOnlyAbortedReceives( receiver );
+	std::atomic<int> numReceived( 0 );
+	std::atomic<long> sum( 0 );
+	std::mutex threadsMutex;
+	std::set<std::thread::id> threads;
+	receiver.setViewListener( "/shard", [&]( const osc::MessageView &view ) {
+		sum += view.getArgInt( 0 );
+		{
+			std::lock_guard<std::mutex> lock( threadsMutex );
+			threads.insert( std::this_thread::get_id() );
+		}
+		++numReceived;
+	});
+	receiver.bind();
+	receiver.listen();
+	
+	// every socket is its own flow, which the kernel hashes to one of the shards.
+	asio::io_service io;
+	asio::ip::udp::endpoint destination( asio::ip::address_v4::loopback(), port );
+	std::vector<std::unique_ptr<asio::ip::udp::socket>> sockets;
+	for( int i = 0; i < 32; i++ )
+		sockets.emplace_back( new asio::ip::udp::socket( io, asio::ip::udp::endpoint( asio::ip::address_v4::loopback(), 0 ) ) );
+	osc::Message message( "/shard", 0 );
+	uint8_t packet[64];
+	auto sendAll = [&]( int first, int count ) {
+		long expected = 0;
+		for( int i = first; i < first + count; i++ ) {
+			message.setArg( 0, i );
+			expected += i;
+			size_t size = message.encodeInto( packet, sizeof( packet ) );
+			sockets[i % sockets.size()]->send_to( asio::buffer( packet, size ), destination );
+			// don't overrun the receive buffers of the shards.
+			if( i % 64 == 0 )
+				std::this_thread::sleep_for( std::chrono::microseconds( 200 ) );
+		}
+		return expected;
+	};
+	
+	long expected = sendAll( 0, 640 );
+	OSC_CHECK( waitUntil( [&] { return numReceived == 640; } ) );
+	OSC_CHECK( sum == expected );
+	OSC_CHECK( threads.size() > 1 );
+	receiver.close();
+	
+	// listens again after close, also in batch mode.
+	for( int batchSize = 0; batchSize <= 8; batchSize += 8 ) {
+		receiver.setBatchReceive( batchSize );
+		receiver.bind();
+		receiver.listen();
+		numReceived = 0;
+		sum = 0;
+		expected = sendAll( 0, 64 );
+		OSC_CHECK( waitUntil( [&] { return numReceived == 64; } ) );
+		OSC_CHECK( sum == expected );
+		receiver.close();
+	}
+	// closing twice is fine.
+	receiver.close();
+}
+
+OSC_TEST( shardsRefusePolling )
+{
+	auto port = getFreePort();
+	osc::ReceiverUdpSharded receiver( port, 2 );
+	expectOnlyAbortedReceives( receiver );
+	// inline listeners keep running on the shards' threads.
+	receiver.setPolling( 64 );
+	std::atomic<int> numReceived( 0 );
+	receiver.setListener( "/shard", [&]( const osc::Message & ) {
+		++numReceived;
+	});
+	receiver.bind();
+	receiver.listen();
+	
+	asio::io_service io;
+	asio::ip::udp::socket socket( io, asio::ip::udp::endpoint( asio::ip::address_v4::loopback(), 0 ) );
+	osc::Message message( "/shard", 1 );
+	std::vector<uint8_t> packet( message.encodedSize() );
+	message.encodeInto( packet.data(), packet.size() );
+	socket.send_to( asio::buffer( packet ), asio::ip::udp::endpoint( asio::ip::address_v4::loopback(), port ) );
+	OSC_CHECK( waitUntil( [&] { return numReceived == 1; } ) );
+	OSC_CHECK( receiver.poll() == 0 );
+	receiver.close();
+}
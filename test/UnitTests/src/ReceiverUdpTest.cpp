@@ -0,0 +1,117 @@
+#include "UnitTest.h"
+
+using namespace std;
+
+namespace {
+
+//! Sends raw datagrams to a receiver on the loopback interface.
+class LoopbackSocket {
+public:
+	LoopbackSocket( asio::io_service &io, uint16_t port )
+		: mSocket( io, asio::ip::udp::endpoint( asio::ip::address_v4::loopback(), 0 ) ),
+		mDestination( asio::ip::address_v4::loopback(), port )
+	{
+	}
+	
+	//! Sends \a message as a single datagram, synchronously.
+	void send( const osc::Message &message )
+	{
+		std::vector<uint8_t> packet( message.encodedSize() );
+		message.encodeInto( packet.data(), packet.size() );
+		mSocket.send_to( asio::buffer( packet ), mDestination );
+	}
+	
+	asio::ip::udp::socket	mSocket;
+	asio::ip::udp::endpoint	mDestination;
+};
+
+} // anonymous namespace
+
+OSC_TEST( receiveRingDeliversEveryDatagram )
+{
+	asio::io_service io;
+	osc::ReceiverUdp receiver( 0, asio::ip::udp::v4(), io );
+	receiver.setReceiveBufferCount( 2 );
+	receiver.bind();
+	receiver.listen();
+	std::vector<int> values;
+	receiver.setListener( "/ring", [&]( const osc::Message &message ) {
+		values.push_back( message.getArgInt( 0 ) );
+	});
+	
+	// more datagrams than buffers in the ring, sent before any is received.
+	LoopbackSocket socket( io, receiver.getLocalEndpoint().port() );
+	for( int i = 0; i < 10; i++ )
+		socket.send( osc::Message( "/ring", i ) );
+	OSC_CHECK( test::pollUntil( io, [&] { return values.size() == 10; } ) );
+	for( size_t i = 0; i < values.size(); i++ )
+		OSC_CHECK( values[i] == int( i ) );
+	receiver.close();
+}
+
+OSC_TEST( receivingDoesntAllocate )
+{
+	asio::io_service io;
+	osc::ReceiverUdp receiver( 0, asio::ip::udp::v4(), io );
+	receiver.bind();
+	receiver.listen();
+	int numReceived = 0, last = -1;
+	receiver.setViewListener( "/view", [&]( const osc::MessageView &view ) {
+		++numReceived;
+		last = view.getArgInt( 0 );
+	});
+	
+	osc::Message message( "/view", 0 );
+	uint8_t packet[64];
+	size_t size = message.encodeInto( packet, sizeof( packet ) );
+	LoopbackSocket socket( io, receiver.getLocalEndpoint().port() );
+	auto sendAndReceive = [&]( int i ) {
+		message.setArg( 0, i );
+		message.encodeInto( packet, sizeof( packet ) );
+		socket.mSocket.send_to( asio::buffer( packet, size ), socket.mDestination );
+		return test::pollUntil( io, [&] { return numReceived == i + 1; } );
+	};
+	// the first datagram caches the decode plan of its type tag.
+	OSC_CHECK( sendAndReceive( 0 ) );
+	
+	auto numAllocations = test::getNumAllocations();
+	for( int i = 1; i < 100; i++ )
+		if( ! sendAndReceive( i ) )
+			break;
+	OSC_CHECK( numReceived == 100 && last == 99 );
+	OSC_CHECK( test::getNumAllocations() == numAllocations );
+	receiver.close();
+}
+
+OSC_TEST( batchReceiveDispatchesInOrder )
+{
+	// elsewhere than on Linux this falls back to receiving one datagram at a time.
+	for( int useGro = 0; useGro < 2; useGro++ ) {
+		asio::io_service io;
+		osc::ReceiverUdp receiver( 0, asio::ip::udp::v4(), io );
+		receiver.setBatchReceive( 16, useGro != 0 );
+		if( useGro )
+			receiver.setAmountToReceive( 65536 );
+		receiver.bind();
+		receiver.listen();
+		std::vector<int> values;
+		auto listener = [&]( const osc::MessageView &view ) {
+			values.push_back( view.getArgInt( 0 ) );
+		};
+		receiver.setViewListener( "/batch", listener );
+		receiver.setViewListener( "/batch/long", listener );
+		
+		// more than a batch, mixing sizes so that only some datagrams can be coalesced.
+		LoopbackSocket socket( io, receiver.getLocalEndpoint().port() );
+		for( int i = 0; i < 100; i++ ) {
+			if( i % 7 == 0 )
+				socket.send( osc::Message( "/batch/long", i, std::string( i % 5, 'a' ) ) );
+			else
+				socket.send( osc::Message( "/batch", i ) );
+		}
+		OSC_CHECK( test::pollUntil( io, [&] { return values.size() == 100; } ) );
+		for( size_t i = 0; i < values.size(); i++ )
+			OSC_CHECK( values[i] == int( i ) );
+		receiver.close();
+	}
+}
@@ -0,0 +1,71 @@
+#include "UnitTest.h"
+
+using namespace std;
+
+namespace {
+
+//! Returns messages to \a count, mostly of the same size with a few longer ones in between, so a
+//! batch has both runs for a segmented send and datagrams for sendmmsg.
+std::vector<osc::Message> makeMessages( int count )
+{
+	std::vector<osc::Message> messages;
+	for( int i = 0; i < count; i++ ) {
+		if( i % 9 == 0 )
+			messages.emplace_back( "/batch/long", i, std::string( i % 5, 'a' ) );
+		else
+			messages.emplace_back( "/batch", i );
+	}
+	return messages;
+}
+
+} // anonymous namespace
+
+OSC_TEST( batchedSendKeepsTheOrder )
+{
+	asio::io_service io;
+	osc::ReceiverUdp receiver( 0, asio::ip::udp::v4(), io );
+	receiver.bind();
+	receiver.listen();
+	std::vector<int> values;
+	auto listener = [&]( const osc::MessageView &view ) {
+		values.push_back( view.getArgInt( 0 ) );
+	};
+	receiver.setViewListener( "/batch", listener );
+	receiver.setViewListener( "/batch/long", listener );
+	
+	osc::SenderUdp sender( 0, "127.0.0.1", receiver.getLocalEndpoint().port(), asio::ip::udp::v4(), io );
+	sender.bind();
+	auto messages = makeMessages( 150 );
+	sender.send( messages.data(), 100 );
+	// a later batch is sent after the first, even if that one was queued.
+	sender.send( messages.data() + 100, 50 );
+	OSC_CHECK( test::pollUntil( io, [&] { return values.size() == 150; } ) );
+	for( size_t i = 0; i < values.size(); i++ )
+		OSC_CHECK( values[i] == int( i ) );
+	
+	// single sends still work in between batches.
+	sender.send( osc::Message( "/batch", 150 ) );
+	sender.send( std::vector<osc::Message>() );
+	OSC_CHECK( test::pollUntil( io, [&] { return values.size() == 151; } ) );
+	OSC_CHECK( values.back() == 150 );
+	sender.close();
+	receiver.close();
+}
+
+OSC_TEST( batchedSendReportsErrorsPerMessage )
+{
+	asio::io_service io;
+	// never bound, so every send fails.
+	osc::SenderUdp sender( 0, "127.0.0.1", 9, asio::ip::udp::v4(), io );
+	std::vector<std::string> addresses;
+	sender.setSocketTransportErrorFn( [&]( const asio::error_code &error, const std::string &address ) {
+		OSC_CHECK( error );
+		addresses.push_back( address );
+	});
+	auto messages = makeMessages( 20 );
+	sender.send( messages );
+	io.poll();
+	OSC_CHECK( addresses.size() == 20 );
+	for( size_t i = 0; i < addresses.size(); i++ )
+		OSC_CHECK( addresses[i] == messages[i].getAddress() );
+}
@@ -0,0 +1,70 @@
+#include "UnitTest.h"
+
+using namespace std;
+
+namespace {
+
+osc::Message makeMessage( int32_t i, float f, double d, int64_t h, char c, bool b, uint8_t midi, uint64_t time )
+{
+	osc::Message message( "/a", i, f, d, h, c, b );
+	message.appendMidi( midi, 8, 7, 6 );
+	message.append( std::string( "const" ) );
+	message.appendTimeTag( time );
+	return message;
+}
+
+} // anonymous namespace
+
+OSC_TEST( setArgPatchesTheCachedMessage )
+{
+	test::CaptureSender sender;
+	auto message = makeMessage( 0, 0.0f, 0.0, 0, 'a', false, 0, 5 );
+	// sending caches the message, so the following sets patch the cache.
+	sender.send( message );
+	message.setArg( 0, 7 );
+	message.setArg( 1, 2.5f );
+	message.setArg( 2, 9.75 );
+	message.setArg( 3, int64_t( -5 ) );
+	message.setArg( 4, 'z' );
+	message.setArg( 5, true );
+	message.setArgMidi( 6, 9, 8, 7, 6 );
+	message.setArgTime( 8, 77 );
+	OSC_CHECK( message.getArgInt( 0 ) == 7 && message.getArgFloat( 1 ) == 2.5f && message.getArgDouble( 2 ) == 9.75 );
+	OSC_CHECK( message.getArgInt64( 3 ) == -5 && message.getArgChar( 4 ) == 'z' && message.getArgBool( 5 ) );
+	OSC_CHECK( message.getArgTime( 8 ) == 77 );
+	sender.send( message );
+	
+	auto expected = makeMessage( 7, 2.5f, 9.75, -5, 'z', true, 9, 77 );
+	OSC_CHECK( message == expected );
+	sender.send( expected );
+	OSC_CHECK( sender.mPackets[1] == sender.mPackets[2] );
+	
+	test::LoopbackReceiver receiver;
+	int numReceived = 0;
+	receiver.setListener( "/a", [&]( const osc::Message &received ) {
+		++numReceived;
+		OSC_CHECK( received == expected );
+	});
+	receiver.dispatch( sender.mPackets[1] );
+	OSC_CHECK( numReceived == 1 );
+}
+
+OSC_TEST( setArgBeforeCaching )
+{
+	test::CaptureSender sender;
+	osc::Message message( "/a", 1, 2.0f );
+	message.setArg( 1, 3.0f );
+	sender.send( message );
+	osc::Message expected( "/a", 1, 3.0f );
+	sender.send( expected );
+	OSC_CHECK( sender.mPackets[0] == sender.mPackets[1] );
+}
+
+OSC_TEST( setArgRejectsOtherTypes )
+{
+	osc::Message message( "/a", 1, 2.0f, std::string( "text" ) );
+	OSC_CHECK_THROWS( message.setArg( 0, 1.0f ), osc::ExcNonConvertible );
+	OSC_CHECK_THROWS( message.setArg( 2, 1 ), osc::ExcNonConvertible );
+	OSC_CHECK_THROWS( message.setArg( 3, 1 ), osc::ExcIndexOutOfBounds );
+	OSC_CHECK( message.getArgInt( 0 ) == 1 );
+}
@@ -0,0 +1,55 @@
+#include "UnitTest.h"
+
+using namespace std;
+
+namespace {
+
+OSC_ADDRESS( MixChannel, "/mix/ch" );
+OSC_ADDRESS( FourChars, "/abc" );
+
+using MixMessage = osc::TypedMessage<MixChannel, int32_t, float, float, double, int64_t, char, bool>;
+
+static_assert( MixMessage::addressSize == 8, "the address is padded to a multiple of 4" );
+static_assert( MixMessage::typesSize == 12, "the type tag is padded to a multiple of 4" );
+static_assert( MixMessage::packetSize == 4 + 8 + 12 + 4 + 4 + 4 + 8 + 8 + 4, "the packet size is known at compile time" );
+static_assert( osc::TypedMessage<FourChars>::addressSize == 8, "a 4 char address gets a whole word of padding" );
+
+} // anonymous namespace
+
+OSC_TEST( typedMessageEncodesLikeMessage )
+{
+	test::CaptureSender sender;
+	MixMessage typed( 0, 0, 0, 0, 0, 'a', false );
+	typed.set( 3, 0.5f, -1.0f, 2.5, -9, 'q', true );
+	sender.send( typed );
+	osc::Message message( "/mix/ch", 3, 0.5f, -1.0f, 2.5, int64_t( -9 ), 'q', true );
+	sender.send( message );
+	OSC_CHECK( sender.mPackets[0] == sender.mPackets[1] );
+	OSC_CHECK( MixMessage::size() == message.size() );
+	
+	MixMessage::Packet packet;
+	MixMessage::encode( packet, 3, 0.5f, -1.0f, 2.5, -9, 'q', true );
+	OSC_CHECK( std::equal( packet.begin() + 4, packet.end(), sender.mPackets[0].begin() ) );
+	
+	osc::TypedMessage<FourChars> empty;
+	sender.send( empty );
+	sender.send( osc::Message( "/abc" ) );
+	OSC_CHECK( sender.mPackets[2] == sender.mPackets[3] );
+}
+
+OSC_TEST( typedMessageDecodes )
+{
+	test::CaptureSender sender;
+	test::LoopbackReceiver receiver;
+	int numReceived = 0;
+	receiver.setListener( MixMessage::getAddress(), [&]( const osc::Message &message ) {
+		++numReceived;
+		OSC_CHECK( message[0].int32() == 3 && message[1].flt() == 0.5f && message[2].flt() == -1.0f );
+		OSC_CHECK( message[3].dbl() == 2.5 && message[4].int64() == -9 && message[5].character() == 'q' );
+		OSC_CHECK( message[6].boolean() );
+	});
+	MixMessage typed( 3, 0.5f, -1.0f, 2.5, -9, 'q', true );
+	sender.send( typed );
+	receiver.dispatch( sender.getLastPacket() );
+	OSC_CHECK( numReceived == 1 );
+}
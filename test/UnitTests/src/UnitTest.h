@@ -0,0 +1,94 @@
+#pragma once
+
+// A minimal harness for the unit tests, which run without a network or an app. Every test file
+// registers its tests with OSC_TEST, and UnitTests.cpp runs them all.
+
+#include "Osc.h"
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace test {
+
+//! Registers the test \a fn as \a name, to be run by runTests().
+struct Registrar {
+	Registrar( const char *name, std::function<void()> fn );
+};
+
+//! Reports that \a expression didn't hold at \a file and \a line, which fails the current test.
+void reportFailure( const char *expression, const char *file, int line );
+
+//! Returns the amount of allocations with operator new so far, by any thread.
+size_t getNumAllocations();
+
+//! Polls \a io until \a done returns true or a second has passed, so a lost datagram fails the
+//! test instead of hanging it. Returns \a done's last result.
+template<typename DoneFn>
+bool pollUntil( asio::io_service &io, const DoneFn &done )
+{
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds( 1 );
+	while( ! done() && std::chrono::steady_clock::now() < deadline )
+		io.poll();
+	return done();
+}
+
+//! Keeps every packet sent, without its size prefix, instead of sending it.
+class CaptureSender : public osc::SenderBase {
+public:
+	//! Returns the last packet sent.
+	const osc::ByteBuffer& getLastPacket() const { return mPackets.back(); }
+	
+	std::vector<osc::ByteBuffer>	mPackets;
+
+protected:
+	using SenderBase::sendImpl;
+	void sendImpl( const osc::ByteBufferRef &byteBuffer ) override
+	{
+		mPackets.emplace_back( byteBuffer->begin() + 4, byteBuffer->end() );
+	}
+	void closeImpl() override {}
+	void bindImpl() override {}
+};
+
+//! Dispatches packets straight to its listeners, without a socket.
+class LoopbackReceiver : public osc::ReceiverBase {
+public:
+	//! Dispatches a copy of \a packet, as the decoder swaps the arguments of the packet in place.
+	void dispatch( osc::ByteBuffer packet )
+	{
+		dispatchMethods( packet.data(), static_cast<uint32_t>( packet.size() ) );
+	}
+	//! Dispatches the \a size bytes at \a data in place, which leaves them swapped.
+	void dispatch( uint8_t *data, size_t size )
+	{
+		dispatchMethods( data, static_cast<uint32_t>( size ) );
+	}
+
+protected:
+	void bindImpl() override {}
+	void listenImpl() override {}
+	void closeImpl() override {}
+};
+
+} // namespace test
+
+//! Defines and registers the test \a name.
+#define OSC_TEST( name ) \
+	static void name(); \
+	static test::Registrar name##Registrar( #name, name ); \
+	static void name()
+
+//! Fails the current test, but keeps running it, if \a expression doesn't hold.
+#define OSC_CHECK( expression ) \
+	do { if( ! ( expression ) ) test::reportFailure( #expression, __FILE__, __LINE__ ); } while( 0 )
+
+//! Fails the current test if \a expression doesn't throw an \a Exception.
+#define OSC_CHECK_THROWS( expression, Exception ) \
+	do { \
+		bool threw = false; \
+		try { expression; } catch( const Exception & ) { threw = true; } \
+		if( ! threw ) test::reportFailure( #expression " throws " #Exception, __FILE__, __LINE__ ); \
+	} while( 0 )
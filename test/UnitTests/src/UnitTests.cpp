@@ -0,0 +1,60 @@
+// Runs every registered unit test and returns the amount that failed. The tests are built
+// together with the block's sources:
+//
+//	c++ -std=c++11 -I../../../src -I<cinder>/include ../../../src/Osc.cpp *.cpp -o UnitTests -lpthread
+
+#include "UnitTest.h"
+
+using namespace std;
+
+namespace test {
+
+namespace {
+
+struct TestCase {
+	const char				*mName;
+	std::function<void()>	mFn;
+};
+
+std::vector<TestCase>& getTestCases()
+{
+	static std::vector<TestCase> testCases;
+	return testCases;
+}
+
+size_t sNumFailures = 0;
+
+} // anonymous namespace
+
+Registrar::Registrar( const char *name, std::function<void()> fn )
+{
+	getTestCases().push_back( { name, fn } );
+}
+
+void reportFailure( const char *expression, const char *file, int line )
+{
+	cerr << file << ":" << line << ": check failed: " << expression << endl;
+	++sNumFailures;
+}
+
+} // namespace test
+
+int main()
+{
+	int numFailedTests = 0;
+	for( auto & testCase : test::getTestCases() ) {
+		auto numFailures = test::sNumFailures;
+		try {
+			testCase.mFn();
+		}
+		catch( const std::exception &exc ) {
+			cerr << testCase.mName << ": threw " << exc.what() << endl;
+			++test::sNumFailures;
+		}
+		bool passed = test::sNumFailures == numFailures;
+		cout << ( passed ? "passed " : "FAILED " ) << testCase.mName << endl;
+		numFailedTests += ! passed;
+	}
+	cout << test::getTestCases().size() - numFailedTests << " of " << test::getTestCases().size() << " tests passed" << endl;
+	return numFailedTests;
+}